@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+class counting_memory_resource final : public std::pmr::memory_resource {
+public:
+	counting_memory_resource(std::pmr::memory_resource * base = nullptr)
+		: base{base ? base : std::pmr::get_default_resource()}
+	{}
+
+	std::size_t allocations() const noexcept {
+		return allocationCount;
+	}
+
+	std::size_t deallocations() const noexcept {
+		return deallocationCount;
+	}
+
+	std::size_t bytes_in_use() const noexcept {
+		return bytesInUse;
+	}
+
+private:
+	virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		void* const p = base->allocate(bytes, alignment);
+		++allocationCount;
+		bytesInUse += bytes;
+		return p;
+	}
+
+	virtual void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override {
+		++deallocationCount;
+		bytesInUse -= bytes;
+		base->deallocate(p, bytes, alignment);
+	}
+
+	virtual bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+		return this == &other;
+	}
+
+	std::pmr::memory_resource * base;
+	std::size_t allocationCount = 0u;
+	std::size_t deallocationCount = 0u;
+	std::size_t bytesInUse = 0u;
+};
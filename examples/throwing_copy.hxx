@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdexcept>
+
+// copying the element holding 1 throws, for testing that containers clean up after a failed copy
+struct throwing_copy final {
+	int value;
+
+	throwing_copy(int const value)
+		: value{value}
+	{}
+
+	throwing_copy(throwing_copy const& other)
+		: value{other.value}
+	{
+		if (value == 1)
+			throw std::runtime_error{ "copy failed" };
+	}
+};
@@ -0,0 +1,104 @@
+#include "band_workers.hxx"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace workshop {
+	namespace {
+		// only a hint, the bands are computed correctly without it
+		void pin(std::thread& thread, int const band) {
+			int const processors = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+#if defined(_WIN32)
+			SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (band % std::min(processors, 64)));
+#elif defined(__linux__)
+			cpu_set_t processor;
+			CPU_ZERO(&processor);
+			CPU_SET(band % std::min(processors, CPU_SETSIZE), &processor);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(processor), &processor);
+#else
+			static_cast<void>(thread);
+			static_cast<void>(band);
+			static_cast<void>(processors);
+#endif
+		}
+	}
+
+	BandWorkers::BandWorkers(int const workers)
+		: m_workers{ std::max(workers, 1) }
+	{
+		if (m_workers <= 1)
+			return;
+
+		try {
+			m_threads.reserve(static_cast<std::size_t>(m_workers));
+			for (int band = 0; band < m_workers; ++band) {
+				m_threads.emplace_back([this, band] { work(band); });
+				pin(m_threads.back(), band);
+			}
+		}
+		catch (...) {
+			stop();
+			throw;
+		}
+	}
+
+	BandWorkers::~BandWorkers() noexcept {
+		stop();
+	}
+
+	void BandWorkers::dispatch(int const count, Task const task, void* const context) {
+		std::unique_lock<std::mutex> lock{ m_mutex };
+		m_task = task;
+		m_context = context;
+		m_count = count;
+		m_pending = m_workers;
+		++m_generation;
+		m_started.notify_all();
+
+		m_finished.wait(lock, [this] { return m_pending == 0; });
+		m_task = nullptr;
+		m_context = nullptr;
+	}
+
+	void BandWorkers::work(int const band) {
+		std::uint64_t done{ 0u };
+		std::unique_lock<std::mutex> lock{ m_mutex };
+		for (;;) {
+			m_started.wait(lock, [this, done] { return m_stopping || m_generation != done; });
+			if (m_stopping)
+				return;
+
+			done = m_generation;
+			Task const task = m_task;
+			void* const context = m_context;
+			auto const [begin, end] = rowBand(m_count, m_workers, band);
+
+			lock.unlock();
+			task(context, begin, end);
+			lock.lock();
+
+			if (--m_pending == 0)
+				m_finished.notify_one();
+		}
+	}
+
+	void BandWorkers::stop() noexcept {
+		{
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			m_stopping = true;
+		}
+		m_started.notify_all();
+
+		for (auto& thread : m_threads) {
+			thread.join();
+		}
+		m_threads.clear();
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace workshop {
+	/**
+	 * @brief rowBand splits height rows into workers bands of (almost) equal size.
+	 * @return The first and one past the last row of the band with the given index.
+	 */
+	inline std::array<int, 2> rowBand(int const height, int const workers, int const index) {
+		return {
+			static_cast<int>(static_cast<std::int64_t>(height) * index / workers),
+			static_cast<int>(static_cast<std::int64_t>(height) * (index + 1) / workers),
+		};
+	}
+
+	/**
+	 * @brief BandWorkers keeps one thread per band of rows alive between calls, so running the bands
+	 * neither starts threads nor allocates, and band n is always processed by the same thread.
+	 * On Linux and Windows that thread is pinned to logical processor n (modulo their number),
+	 * so with first-touch placement the memory of a band stays on the NUMA node of its thread.
+	 * With a single worker the band is processed by the calling thread instead.
+	 */
+	class BandWorkers final {
+	public:
+		explicit BandWorkers(int workers);
+
+		BandWorkers(BandWorkers const&) = delete;
+		BandWorkers& operator = (BandWorkers const&) = delete;
+
+		~BandWorkers() noexcept;
+
+		int workers() const noexcept {
+			return m_workers;
+		}
+
+		/**
+		 * @brief run splits count rows into one band per worker and calls f(begin, end) for each of them
+		 * on the thread of that band, returning once all of them are done.
+		 * Like in a std::thread, an exception escaping f terminates the program.
+		 */
+		template <typename F>
+		void run(int const count, F& f) {
+			if (m_workers <= 1) {
+				f(0, count);
+				return;
+			}
+
+			dispatch(count, [](void* const context, int const begin, int const end) {
+				(*static_cast<F*>(context))(begin, end);
+			}, const_cast<void*>(static_cast<void const*>(&f)));
+		}
+
+	private:
+		using Task = void (*)(void* context, int begin, int end);
+
+		int m_workers;
+		std::mutex m_mutex{};
+		std::condition_variable m_started{};
+		std::condition_variable m_finished{};
+		// counts the tasks, so every thread runs each of them exactly once
+		std::uint64_t m_generation{ 0u };
+		int m_pending{ 0 };
+		bool m_stopping{ false };
+		Task m_task{ nullptr };
+		void* m_context{ nullptr };
+		int m_count{ 0 };
+		std::vector<std::thread> m_threads{};
+
+		void dispatch(int count, Task task, void* context);
+		void work(int band);
+		void stop() noexcept;
+	};
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+namespace t = testing;
+
+#include "band_workers.hxx"
+namespace w = workshop;
+
+#include <thread>
+#include <vector>
+
+TEST(BandWorkersTest, runsEveryBandOnceOnItsOwnThread) {
+	w::BandWorkers workers{ 3 };
+	std::vector<int> visits(10u, 0);
+	// by the first row of each band
+	std::vector<std::thread::id> threads(10u);
+
+	for (int n = 0; n < 100; ++n) {
+		auto count = [&](int const begin, int const end) {
+			for (int row = begin; row < end; ++row) {
+				++visits[static_cast<std::size_t>(row)];
+			}
+			if (n == 0)
+				threads[static_cast<std::size_t>(begin)] = std::this_thread::get_id();
+			else
+				EXPECT_EQ(threads[static_cast<std::size_t>(begin)], std::this_thread::get_id());
+		};
+		workers.run(10, count);
+	}
+
+	EXPECT_EQ(std::vector<int>(10u, 100), visits);
+	// the bands are rows 0 to 2, 3 to 5 and 6 to 9
+	EXPECT_NE(threads[0], threads[3]);
+	EXPECT_NE(threads[3], threads[6]);
+	EXPECT_NE(threads[0], threads[6]);
+	EXPECT_NE(std::this_thread::get_id(), threads[0]);
+}
+
+TEST(BandWorkersTest, runsASingleBandOnTheCallingThread) {
+	w::BandWorkers workers{ 1 };
+	std::thread::id thread{};
+	auto record = [&](int const begin, int const end) {
+		EXPECT_EQ(0, begin);
+		EXPECT_EQ(10, end);
+		thread = std::this_thread::get_id();
+	};
+	workers.run(10, record);
+	EXPECT_EQ(std::this_thread::get_id(), thread);
+}
@@ -0,0 +1,394 @@
+#include "census.hxx"
+#include "lattice.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace workshop {
+	namespace {
+		// a horizontal run of living cells from begin to end (exclusive) in row y
+		struct Run final {
+			int y;
+			int begin;
+			int end;
+		};
+
+		// runs in neighbouring rows belong to the same object if they touch, diagonally included
+		bool touching(Run const& upper, Run const& lower) {
+			return upper.begin <= lower.end && lower.begin <= upper.end;
+		}
+
+		// union-find over run indices, roots always being the smallest index of their set,
+		// so parent[i] <= i holds at all times
+		std::size_t findRoot(std::vector<std::size_t>& parent, std::size_t i) {
+			while (parent[i] != i) {
+				parent[i] = parent[parent[i]];
+				i = parent[i];
+			}
+			return i;
+		}
+
+		void unite(std::vector<std::size_t>& parent, std::size_t const a, std::size_t const b) {
+			std::size_t const rootA = findRoot(parent, a);
+			std::size_t const rootB = findRoot(parent, b);
+			if (rootA < rootB)
+				parent[rootB] = rootA;
+			else if (rootB < rootA)
+				parent[rootA] = rootB;
+		}
+
+		// unites the touching runs of two neighbouring rows, both given as index ranges sorted by column
+		void uniteRows(
+			std::vector<Run> const& runs, std::vector<std::size_t>& parent,
+			std::size_t upper, std::size_t const upperEnd,
+			std::size_t lower, std::size_t const lowerEnd
+		) {
+			while (upper < upperEnd && lower < lowerEnd) {
+				if (touching(runs[upper], runs[lower]))
+					unite(parent, upper, lower);
+
+				// whichever run ends first cannot touch any further run of the other row
+				if (runs[upper].end < runs[lower].end)
+					++upper;
+				else
+					++lower;
+			}
+		}
+
+		// finds the runs of one row, skipping 8 dead cells at a time
+		void appendRuns(std::vector<Run>& runs, CellState const* const row, int const width, int const y) {
+			int x = 0;
+			while (x < width) {
+				for (std::uint64_t word; x + 8 <= width; x += 8) {
+					std::memcpy(&word, row + x, sizeof(word));
+					if (word != 0u)
+						break;
+				}
+				while (x < width && row[x] == CellState::Dead)
+					++x;
+				if (x == width)
+					break;
+
+				int const begin = x;
+				while (x < width && row[x] == CellState::Alive)
+					++x;
+				runs.push_back({ y, begin, x });
+			}
+		}
+
+		struct Band final {
+			std::vector<Run> runs;
+			std::vector<std::size_t> parent;
+		};
+
+		void scanBand(GameOfLife const& game, int const yBegin, int const yEnd, Band& band) {
+			std::vector<CellState> row(static_cast<std::size_t>(game.width()));
+			std::size_t previousBegin = 0u;
+			std::size_t previousEnd = 0u;
+
+			for (int y = yBegin; y < yEnd; ++y) {
+				game.readRow(0, y, game.width(), row.data());
+
+				std::size_t const currentBegin = band.runs.size();
+				appendRuns(band.runs, row.data(), game.width(), y);
+				std::size_t const currentEnd = band.runs.size();
+
+				for (std::size_t i = currentBegin; i < currentEnd; ++i) {
+					band.parent.push_back(i);
+				}
+				uniteRows(band.runs, band.parent, previousBegin, previousEnd, currentBegin, currentEnd);
+
+				previousBegin = currentBegin;
+				previousEnd = currentEnd;
+			}
+		}
+
+		using Cell = std::array<int, 2>;
+
+		std::string render(std::vector<Cell> const& cells) {
+			int width = 0, height = 0;
+			for (auto const [x, y] : cells) {
+				width = std::max(width, x + 1);
+				height = std::max(height, y + 1);
+			}
+
+			std::string result(static_cast<std::size_t>(width + 1) * height, ' ');
+			for (int y = 0; y < height; ++y) {
+				result[static_cast<std::size_t>(y) * (width + 1) + width] = '\n';
+			}
+			for (auto const [x, y] : cells) {
+				result[static_cast<std::size_t>(y) * (width + 1) + x] = 'X';
+			}
+			return result;
+		}
+
+		// the smallest rendering of all 8 rotations and reflections
+		std::string canonicalize(std::vector<Cell> const& cells) {
+			std::string best{};
+			std::vector<Cell> transformed(cells.size());
+
+			for (int transform = 0; transform < 8; ++transform) {
+				int minX = 0, minY = 0;
+				for (std::size_t n = 0u; n < cells.size(); ++n) {
+					auto [x, y] = cells[n];
+					if (transform & 1)
+						x = -x;
+					if (transform & 2)
+						y = -y;
+					if (transform & 4)
+						std::swap(x, y);
+					transformed[n] = { x, y };
+					minX = (n == 0u) ? x : std::min(minX, x);
+					minY = (n == 0u) ? y : std::min(minY, y);
+				}
+				for (auto& [x, y] : transformed) {
+					x -= minX;
+					y -= minY;
+				}
+
+				std::string candidate = render(transformed);
+				if (transform == 0 || candidate < best)
+					best = std::move(candidate);
+			}
+			return best;
+		}
+
+		std::vector<Cell> parse(std::string_view const pattern) {
+			std::vector<Cell> cells{};
+			int x = 0, y = 0;
+			for (char const c : pattern) {
+				if (c == '\n') {
+					++y;
+					x = 0;
+				}
+				else {
+					if (c == 'X')
+						cells.push_back({ x, y });
+					++x;
+				}
+			}
+			return cells;
+		}
+
+		std::unordered_map<std::string, std::string> const& knownObjects() {
+			static std::unordered_map<std::string, std::string> const objects = [] {
+				std::pair<char const*, char const*> const patterns[]{
+					{ "block", "XX\nXX\n" },
+					{ "blinker", "XXX\n" },
+					{ "beehive", " XX \nX  X\n XX \n" },
+					{ "loaf", " XX \nX  X\n X X\n  X \n" },
+					{ "boat", "XX \nX X\n X \n" },
+					{ "ship", "XX \nX X\n XX\n" },
+					{ "tub", " X \nX X\n X \n" },
+					{ "pond", " XX \nX  X\nX  X\n XX \n" },
+					{ "beacon", "XX  \nXX  \n  XX\n  XX\n" },
+					{ "beacon", "XX  \nX   \n   X\n  XX\n" },
+					{ "glider", " X \n  X\nXXX\n" },
+					{ "glider", "X X\n XX\n X \n" },
+				};
+
+				std::unordered_map<std::string, std::string> result{};
+				for (auto const& [name, pattern] : patterns) {
+					result.emplace(canonicalize(parse(pattern)), name);
+				}
+				return result;
+			}();
+			return objects;
+		}
+
+		// an object fitting into 8 x 8 cells, bit (y * 8 + x) being set for living cells
+		struct SmallObject final {
+			std::uint64_t bits;
+			std::uint8_t width;
+			std::uint8_t height;
+
+			bool operator == (SmallObject const& other) const {
+				return bits == other.bits && width == other.width && height == other.height;
+			}
+
+			std::vector<Cell> cells() const {
+				std::vector<Cell> result{};
+				for (int n = 0; n < 64; ++n) {
+					if ((bits >> n) & 1u)
+						result.push_back({ n % 8, n / 8 });
+				}
+				return result;
+			}
+		};
+
+		struct SmallObjectHash final {
+			std::size_t operator() (SmallObject const& object) const {
+				return std::hash<std::uint64_t>{}(object.bits * 31u + object.width * 8u + object.height);
+			}
+		};
+
+		std::uint64_t fnv1a(std::string_view const text) {
+			std::uint64_t hash = 14695981039346656037ull;
+			for (char const c : text) {
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+
+	std::vector<CensusEntry> census(GameOfLife const& game, int const workers) {
+		int const bandCount = std::max(workers, 1);
+		// the same threads go through all of the parallel steps
+		BandWorkers bandWorkers{ bandCount };
+
+		// 1. every band finds its runs and unites the touching ones
+		std::vector<Band> bands(static_cast<std::size_t>(bandCount));
+		forEachBand(bandCount, bandWorkers, [&](int const begin, int const end) {
+			for (int b = begin; b < end; ++b) {
+				auto const [yBegin, yEnd] = rowBand(game.height(), bandCount, b);
+				scanBand(game, yBegin, yEnd, bands[b]);
+			}
+		});
+
+		// 2. the bands are joined, moving their local indices behind each other
+		std::vector<std::size_t> offsets(bands.size() + 1u, 0u);
+		for (std::size_t b = 0u; b < bands.size(); ++b) {
+			offsets[b + 1u] = offsets[b] + bands[b].runs.size();
+		}
+
+		std::vector<Run> runs(offsets.back());
+		std::vector<std::size_t> parent(offsets.back());
+		forEachBand(bandCount, bandWorkers, [&](int const begin, int const end) {
+			for (int b = begin; b < end; ++b) {
+				std::size_t const offset = offsets[b];
+				std::copy(bands[b].runs.begin(), bands[b].runs.end(), runs.begin() + offset);
+				std::transform(
+					bands[b].parent.begin(), bands[b].parent.end(),
+					parent.begin() + offset,
+					[offset](std::size_t const p) { return p + offset; }
+				);
+				bands[b] = Band{};
+			}
+		});
+
+		// 3. the last row of each band is united with the first row of the next one
+		for (std::size_t b = 1u; b < bands.size(); ++b) {
+			int const firstRow = rowBand(game.height(), bandCount, static_cast<int>(b))[0];
+
+			std::size_t upper = offsets[b];
+			while (upper > 0u && runs[upper - 1u].y == firstRow - 1)
+				--upper;
+			std::size_t lowerEnd = offsets[b];
+			while (lowerEnd < offsets[b + 1u] && runs[lowerEnd].y == firstRow)
+				++lowerEnd;
+
+			uniteRows(runs, parent, upper, offsets[b], offsets[b], lowerEnd);
+		}
+
+		// 4. as parent[i] <= i, a single forward pass points every run directly to its root
+		std::vector<std::size_t> component(runs.size());
+		std::size_t componentCount = 0u;
+		for (std::size_t i = 0u; i < runs.size(); ++i) {
+			parent[i] = parent[parent[i]];
+			component[i] = (parent[i] == i)
+				? componentCount++
+				: component[parent[i]];
+		}
+		parent = {};
+
+		// 5. the runs are sorted by component (counting sort)
+		std::vector<std::size_t> firstRun(componentCount + 1u, 0u);
+		for (std::size_t const c : component) {
+			++firstRun[c + 1u];
+		}
+		for (std::size_t c = 0u; c < componentCount; ++c) {
+			firstRun[c + 1u] += firstRun[c];
+		}
+		std::vector<std::size_t> order(runs.size());
+		{
+			std::vector<std::size_t> next(firstRun.begin(), firstRun.end() - 1);
+			for (std::size_t i = 0u; i < runs.size(); ++i) {
+				order[next[component[i]]++] = i;
+			}
+		}
+		component = {};
+
+		// 6. every band of objects is classified by its own thread, the counts are merged afterwards
+		std::vector<std::unordered_map<SmallObject, std::size_t, SmallObjectHash>> smallCounts(bands.size());
+		std::vector<std::unordered_map<std::string, std::size_t>> largeCounts(bands.size());
+		forEachBand(bandCount, bandWorkers, [&](int const begin, int const end) {
+			std::vector<Cell> cells{};
+			for (int b = begin; b < end; ++b) {
+				// there can be more components than an int holds, so they are not split with rowBand
+				std::size_t const first = componentCount * static_cast<std::size_t>(b) / static_cast<std::size_t>(bandCount);
+				std::size_t const last = componentCount * static_cast<std::size_t>(b + 1) / static_cast<std::size_t>(bandCount);
+				for (std::size_t c = first; c < last; ++c) {
+					Run const& top = runs[order[firstRun[c]]];
+					Run const& bottom = runs[order[firstRun[c + 1] - 1]];
+					int left = top.begin, right = top.end;
+					for (std::size_t r = firstRun[c]; r < firstRun[c + 1]; ++r) {
+						left = std::min(left, runs[order[r]].begin);
+						right = std::max(right, runs[order[r]].end);
+					}
+
+					int const width = right - left;
+					int const height = bottom.y - top.y + 1;
+					if (width <= 8 && height <= 8) {
+						// most objects are small, they are counted per orientation without canonicalizing them
+						SmallObject object{ 0u, static_cast<std::uint8_t>(width), static_cast<std::uint8_t>(height) };
+						for (std::size_t r = firstRun[c]; r < firstRun[c + 1]; ++r) {
+							Run const& run = runs[order[r]];
+							std::uint64_t const bits = (std::uint64_t{ 1 } << (run.end - run.begin)) - 1u;
+							object.bits |= bits << ((run.y - top.y) * 8 + (run.begin - left));
+						}
+						++smallCounts[b][object];
+						continue;
+					}
+
+					cells.clear();
+					for (std::size_t r = firstRun[c]; r < firstRun[c + 1]; ++r) {
+						Run const& run = runs[order[r]];
+						for (int x = run.begin; x < run.end; ++x) {
+							cells.push_back({ x - left, run.y - top.y });
+						}
+					}
+					++largeCounts[b][canonicalize(cells)];
+				}
+			}
+		});
+
+		std::unordered_map<std::string, std::size_t> counts{};
+		for (auto& partial : largeCounts) {
+			for (auto& [canonical, count] : partial) {
+				counts[canonical] += count;
+			}
+		}
+		std::unordered_map<SmallObject, std::size_t, SmallObjectHash> small{};
+		for (auto& partial : smallCounts) {
+			for (auto& [object, count] : partial) {
+				small[object] += count;
+			}
+		}
+		for (auto& [object, count] : small) {
+			counts[canonicalize(object.cells())] += count;
+		}
+
+		auto const& known = knownObjects();
+		std::vector<CensusEntry> result{};
+		result.reserve(counts.size());
+		for (auto& [canonical, count] : counts) {
+			auto const it = known.find(canonical);
+			result.push_back({
+				fnv1a(canonical),
+				it != known.end() ? it->second : std::string{},
+				canonical,
+				count,
+			});
+		}
+		std::sort(result.begin(), result.end(), [](CensusEntry const& lhs, CensusEntry const& rhs) {
+			return std::tie(rhs.count, lhs.canonical) < std::tie(lhs.count, rhs.canonical);
+		});
+		return result;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "game_of_life.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace workshop {
+	struct CensusEntry final {
+		// hash of canonical
+		std::uint64_t hash;
+		// the name of well known objects like "block" or "glider", empty otherwise
+		std::string name;
+		// the object in the orientation with the smallest representation of all rotations and reflections,
+		// one line per row, 'X' for living and ' ' for dead cells
+		std::string canonical;
+		std::size_t count;
+	};
+
+	/**
+	 * @brief census counts the objects on the board, an object being a cluster of living cells
+	 * connected horizontally, vertically or diagonally. Objects that only differ by rotation
+	 * or reflection are counted together.
+	 * @param game The board to look at.
+	 * @param workers The number of threads scanning bands of rows and classifying objects in parallel.
+	 * @return One entry per kind of object, most frequent first.
+	 */
+	std::vector<CensusEntry> census(GameOfLife const& game, int workers = 1);
+}
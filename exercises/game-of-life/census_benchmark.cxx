@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "census.hxx"
+namespace w = workshop;
+
+namespace {
+	void BM_census(benchmark::State& state) {
+		int const size = static_cast<int>(state.range(0));
+		int const workers = static_cast<int>(state.range(1));
+
+		// a field full of blocks and blinkers, 4 x 4 cells per object
+		w::GameOfLife block{ 2, 2 };
+		w::GameOfLife blinker{ 3, 1 };
+		for (int n = 0; n < 4; ++n) {
+			block(n % 2, n / 2) = w::CellState::Alive;
+			blinker(n % 3, 0) = w::CellState::Alive;
+		}
+
+		w::GameOfLife game{ size, size, w::Layout::RowMajor, std::pmr::get_default_resource(), workers };
+		for (int y = 0; y < size; y += 4) {
+			for (int x = 0; x < size; x += 4) {
+				game.stamp(((x + y) / 4) % 3 ? block : blinker, x, y);
+			}
+		}
+
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(w::census(game, workers));
+		}
+
+		state.SetItemsProcessed(state.iterations() * size * size);
+	}
+}
+
+BENCHMARK(BM_census)
+	->ArgsProduct({ { 1024, 8192 }, { 1, 4 } })
+	->ArgNames({ "size", "workers" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
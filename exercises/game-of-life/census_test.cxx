@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+namespace t = testing;
+
+#include "census.hxx"
+namespace w = workshop;
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace {
+	w::GameOfLife parse(char const* pattern) {
+		int width = 0, height = 0, x = 0;
+		for (char const* cp = pattern; *cp; ++cp) {
+			if (*cp == '\n') {
+				++height;
+				x = 0;
+			}
+			else {
+				width = std::max(width, ++x);
+			}
+		}
+
+		w::GameOfLife game{ width, height };
+		x = 0;
+		int y = 0;
+		for (char const* cp = pattern; *cp; ++cp) {
+			if (*cp == '\n') {
+				++y;
+				x = 0;
+			}
+			else {
+				if (*cp == 'X')
+					game(x, y) = w::CellState::Alive;
+				++x;
+			}
+		}
+		return game;
+	}
+
+	std::map<std::string, std::size_t> byName(std::vector<w::CensusEntry> const& entries) {
+		std::map<std::string, std::size_t> result{};
+		for (auto const& entry : entries) {
+			result[entry.name.empty() ? entry.canonical : entry.name] += entry.count;
+		}
+		return result;
+	}
+}
+
+TEST(CensusTest, emptyBoardHasNoObjects) {
+	w::GameOfLife const game{ 10, 10 };
+	EXPECT_TRUE(w::census(game).empty());
+}
+
+TEST(CensusTest, classifiesObjectsInAnyOrientation) {
+	auto const game = parse(
+		"XX        X   \n"
+		"XX   XXX  X   \n"
+		"          X   \n"
+		"  X           \n"
+		"X X      XX   \n"
+		" XX     X  X  \n"
+		"         XX   \n"
+		"              \n"
+		"XX          X \n"
+		"XX           X\n"
+		"           XXX\n"
+	);
+
+	auto const entries = w::census(game);
+	EXPECT_EQ((std::map<std::string, std::size_t>{
+		{ "beehive", 1u },
+		{ "blinker", 2u },
+		{ "block", 2u },
+		{ "glider", 2u },
+	}), byName(entries));
+
+	// the most frequent objects come first
+	EXPECT_EQ(2u, entries.front().count);
+	EXPECT_EQ(1u, entries.back().count);
+}
+
+TEST(CensusTest, diagonallyTouchingCellsFormOneObject) {
+	auto const game = parse(
+		"X    \n"
+		" X   \n"
+		"  X  \n"
+		"    X\n"
+	);
+
+	std::set<std::string> canonicals{};
+	for (auto const& entry : w::census(game)) {
+		EXPECT_EQ(1u, entry.count);
+		canonicals.insert(entry.canonical);
+	}
+	EXPECT_EQ((std::set<std::string>{
+		"X\n",
+		"  X\n"
+		" X \n"
+		"X  \n",
+	}), canonicals);
+}
+
+TEST(CensusTest, unknownObjectsAreCountedByTheirCanonicalForm) {
+	auto const game = parse(
+		"XX   X \n"
+		"X    XX\n"
+		"       \n"
+		" XX    \n"
+		"  X    \n"
+	);
+
+	auto const entries = w::census(game);
+	ASSERT_EQ(1u, entries.size());
+	EXPECT_EQ(3u, entries[0].count);
+	EXPECT_TRUE(entries[0].name.empty());
+	EXPECT_EQ(
+		" X\n"
+		"XX\n",
+		entries[0].canonical
+	);
+}
+
+TEST(CensusTest, parallelCensusMatchesSequentialCensus) {
+	// objects spanning band borders have to be joined
+	w::GameOfLife game{ 200, 123, w::Layout::Tiled };
+	for (int y = 0; y < game.height(); ++y) {
+		for (int x = 0; x < game.width(); ++x) {
+			if ((x * 7 + y * 13) % 5 < 2)
+				game(x, y) = w::CellState::Alive;
+		}
+	}
+	for (int n = 0; n < 20; ++n) {
+		game.step();
+	}
+
+	auto const sequential = w::census(game);
+	ASSERT_FALSE(sequential.empty());
+	for (int const workers : { 2, 3, 7 }) {
+		auto const parallel = w::census(game, workers);
+		ASSERT_EQ(sequential.size(), parallel.size());
+		for (std::size_t n = 0u; n < sequential.size(); ++n) {
+			EXPECT_EQ(sequential[n].canonical, parallel[n].canonical);
+			EXPECT_EQ(sequential[n].hash, parallel[n].hash);
+			EXPECT_EQ(sequential[n].count, parallel[n].count);
+		}
+	}
+}
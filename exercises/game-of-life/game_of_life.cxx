@@ -1,15 +1,110 @@
 #include "game_of_life.hxx"
+#include "lattice.hxx"
 
+#include <algorithm>
 #include <array>
-#include <stdexcept>
-#include <tuple>
+#include <cstring>
+#include <utility>
 
 namespace workshop {
-	static std::array<std::tuple<int, int>, 8> const neighbors{{
-		{-1, -1}, {0, -1}, {1, -1},
-		{-1, 0},           {1, 0},
-		{-1, 1},  {0, 1},  {1, 1},
-	}};
+	namespace {
+		// B3/S23
+		constexpr LifeLike<CellState> conway{ 1u << 3, (1u << 2) | (1u << 3) };
+
+		// the part of a (width x height) area placed at (x, y) which lies inside of the board
+		struct Overlap final {
+			int boardX;
+			int boardY;
+			int areaX;
+			int areaY;
+			int width;
+			int height;
+
+			bool empty() const {
+				return width <= 0 || height <= 0;
+			}
+		};
+
+		Overlap clip(int const boardWidth, int const boardHeight, int const x, int const y, int const width, int const height) {
+			int const left = std::max(x, 0);
+			int const top = std::max(y, 0);
+			int const right = std::min(x + width, boardWidth);
+			int const bottom = std::min(y + height, boardHeight);
+			return { left, top, left - x, top - y, right - left, bottom - top };
+		}
+
+		// cells are stored as single bytes being either 0 or 1,
+		// so the rows can be combined 8 cells at a time using plain integer operations
+		using Word = std::uint64_t;
+		constexpr int cellsPerWord = sizeof(Word);
+
+		Word loadWord(CellState const* cells) {
+			Word word;
+			std::memcpy(&word, cells, sizeof(Word));
+			return word;
+		}
+
+		void storeWord(CellState* cells, Word const word) {
+			std::memcpy(cells, &word, sizeof(Word));
+		}
+
+		// every byte of word is 0 or 1, so multiplying sums all bytes up in the topmost one
+		int sumBytes(Word const word) {
+			return static_cast<int>((word * 0x0101010101010101ull) >> 56);
+		}
+
+		template <typename Operation>
+		void combineRow(CellState* dst, CellState const* src, int const count, Operation op) {
+			int x = 0;
+			for (; x + cellsPerWord <= count; x += cellsPerWord) {
+				storeWord(dst + x, op(loadWord(dst + x), loadWord(src + x)));
+			}
+			for (; x < count; ++x) {
+				dst[x] = static_cast<CellState>(op(
+					static_cast<Word>(dst[x]),
+					static_cast<Word>(src[x])
+				));
+			}
+		}
+
+		// 64 bit counts, as big boards have more cells than an int can count
+		std::int64_t countRow(CellState const* lhs, CellState const* rhs, std::size_t const count) {
+			std::int64_t result{ 0 };
+			std::size_t x = 0u;
+			for (; x + cellsPerWord <= count; x += cellsPerWord) {
+				result += sumBytes(loadWord(lhs + x) & loadWord(rhs + x));
+			}
+			for (; x < count; ++x) {
+				result += static_cast<int>(lhs[x]) & static_cast<int>(rhs[x]);
+			}
+			return result;
+		}
+
+		// walks count cells of two rows in pieces being contiguous in both of them
+		template <typename Dst, typename Src, typename Operation>
+		void forEachPiece(int const count, Dst dst, Src src, Operation op) {
+			for (int done = 0; done < count;) {
+				int dstLength, srcLength;
+				auto* const d = dst(done, dstLength);
+				auto* const s = src(done, srcLength);
+				int const n = std::min({ dstLength, srcLength, count - done });
+				op(d, s, n);
+				done += n;
+			}
+		}
+
+		int tilesFor(int const cells) {
+			return (cells + GameOfLife::tileSize - 1) / GameOfLife::tileSize;
+		}
+
+		std::size_t storageSize(int const width, int const height, Layout const layout) {
+			if (layout == Layout::RowMajor)
+				return static_cast<std::size_t>(width) * height;
+
+			return static_cast<std::size_t>(tilesFor(width)) * tilesFor(height)
+				* GameOfLife::tileSize * GameOfLife::tileSize;
+		}
+	}
 
 	GameOfLife::CellReference::CellReference(int const x, int const y, GameOfLife& game)
 		: m_x{x}
@@ -19,27 +114,127 @@ namespace workshop {
 
 	GameOfLife::CellReference & GameOfLife::CellReference::operator=(CellState const state) {
 		if (m_game.isInField(m_x, m_y))
-			m_game.m_cells[m_y * m_game.m_width + m_x] = state;
+			m_game.m_cells[m_game.index(m_x, m_y)] = state;
 		return *this;
 	}
 
 	GameOfLife::CellReference::operator CellState() const {
-		return m_game.isInField(m_x, m_y)
-			? m_game.m_cells[m_y * m_game.m_width + m_x]
-			: CellState::Dead;
+		return std::as_const(m_game)(m_x, m_y);
 	}
 
-	GameOfLife::GameOfLife(int const width, int const height)
+	GameOfLife::CellBuffer::CellBuffer(std::size_t const size, std::pmr::memory_resource * const resource)
+		: m_resource{resource}
+		, m_data{size > 0u ? static_cast<CellState*>(resource->allocate(size, alignof(CellState))) : nullptr}
+		, m_size{size}
+	{}
+
+	GameOfLife::CellBuffer::CellBuffer(CellBuffer&& other) noexcept
+		: m_resource{other.m_resource}
+		, m_data{std::exchange(other.m_data, nullptr)}
+		, m_size{std::exchange(other.m_size, 0u)}
+	{}
+
+	GameOfLife::CellBuffer& GameOfLife::CellBuffer::operator=(CellBuffer&& other) noexcept {
+		std::swap(m_resource, other.m_resource);
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	GameOfLife::CellBuffer::~CellBuffer() noexcept {
+		if (m_data)
+			m_resource->deallocate(m_data, m_size, alignof(CellState));
+	}
+
+	CellState* GameOfLife::CellBuffer::data() noexcept {
+		return m_data;
+	}
+
+	CellState const* GameOfLife::CellBuffer::data() const noexcept {
+		return m_data;
+	}
+
+	std::size_t GameOfLife::CellBuffer::size() const noexcept {
+		return m_size;
+	}
+
+	CellState& GameOfLife::CellBuffer::operator[](std::size_t const index) noexcept {
+		return m_data[index];
+	}
+
+	CellState GameOfLife::CellBuffer::operator[](std::size_t const index) const noexcept {
+		return m_data[index];
+	}
+
+	GameOfLife::GameOfLife(
+		int const width, int const height,
+		Layout const layout,
+		std::pmr::memory_resource * const resource,
+		int const workers
+	)
 		: m_width{width}
 		, m_height{height}
-		, m_cells{width * height, CellState::Dead}
-	{}
+		, m_layout{layout}
+		, m_tilesX{tilesFor(width)}
+		, m_workers{workers}
+		, m_bandWorkers{std::make_unique<BandWorkers>(workers)}
+		, m_resource{resource}
+		, m_cells{storageSize(width, height, layout), resource}
+		, m_next{storageSize(width, height, layout), resource}
+	{
+		firstTouch(nullptr);
+	}
+
+	GameOfLife::GameOfLife(GameOfLife const& other)
+		: m_width{other.m_width}
+		, m_height{other.m_height}
+		, m_layout{other.m_layout}
+		, m_tilesX{other.m_tilesX}
+		, m_workers{other.m_workers}
+		, m_bandWorkers{std::make_unique<BandWorkers>(other.m_workers)}
+		, m_resource{other.m_resource}
+		, m_cells{other.m_cells.size(), other.m_resource}
+		, m_next{other.m_next.size(), other.m_resource}
+	{
+		firstTouch(&other);
+	}
+
+	GameOfLife& GameOfLife::operator=(GameOfLife const& other) {
+		if (this != &other) {
+			GameOfLife copy{ other };
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	int GameOfLife::bandRows() const {
+		return m_layout == Layout::RowMajor ? m_height : tilesFor(m_height);
+	}
+
+	std::array<std::size_t, 2> GameOfLife::storageRange(int const begin, int const end) const {
+		std::size_t const stride = (m_layout == Layout::RowMajor)
+			? static_cast<std::size_t>(m_width)
+			: static_cast<std::size_t>(m_tilesX) * tileSize * tileSize;
+		return { begin * stride, end * stride };
+	}
+
+	void GameOfLife::firstTouch(GameOfLife const* const source) {
+		// the bands match the ones step() uses with the same number of workers
+		forEachBand(bandRows(), *m_bandWorkers, [this, source](int const begin, int const end) {
+			auto const [first, last] = storageRange(begin, end);
+			if (source)
+				std::copy(source->m_cells.data() + first, source->m_cells.data() + last, m_cells.data() + first);
+			else
+				std::fill(m_cells.data() + first, m_cells.data() + last, CellState::Dead);
+			std::fill(m_next.data() + first, m_next.data() + last, CellState::Dead);
+		});
+	}
 
 	CellState GameOfLife::operator() (int const x, int const y) const {
 		if (!isInField(x, y))
 			return CellState::Dead;
 
-		return m_cells[y * m_width + x];
+		return m_cells[index(x, y)];
 	}
 
 	GameOfLife::CellReference GameOfLife::operator() (int const x, int const y) {
@@ -51,6 +246,25 @@ namespace workshop {
 		return x >= 0 && y >= 0  && x < m_width && y < m_height;
 	}
 
+	std::size_t GameOfLife::index(int const x, int const y) const {
+		if (m_layout == Layout::RowMajor)
+			return static_cast<std::size_t>(y) * m_width + x;
+
+		std::size_t const tile = static_cast<std::size_t>(y / tileSize) * m_tilesX + x / tileSize;
+		return (tile * tileSize + y % tileSize) * tileSize + x % tileSize;
+	}
+
+	CellState const* GameOfLife::runAt(int const x, int const y, int& length) const {
+		length = (m_layout == Layout::RowMajor)
+			? m_width - x
+			: std::min(tileSize - x % tileSize, m_width - x);
+		return m_cells.data() + index(x, y);
+	}
+
+	CellState* GameOfLife::runAt(int const x, int const y, int& length) {
+		return const_cast<CellState*>(std::as_const(*this).runAt(x, y, length));
+	}
+
 	int GameOfLife::width() const {
 		return m_width;
 	}
@@ -59,31 +273,136 @@ namespace workshop {
 		return m_height;
 	}
 
-	void GameOfLife::step() {
-		GameOfLife old{ *this };
-		for (int y = 0; y < m_height; ++y) {
-			for (int x = 0; x < m_width; ++x) {
-				int const neighbors = old.livingNeighborsOf(x, y);
-				if (neighbors == 3)
-					operator()(x, y) = CellState::Alive;
-				else if (neighbors < 2 || neighbors > 3)
-					operator()(x, y) = CellState::Dead;
-			}
+	Layout GameOfLife::layout() const {
+		return m_layout;
+	}
+
+	void GameOfLife::readRow(int const x, int const y, int const count, CellState* const out) const {
+		Overlap const overlap = clip(m_width, m_height, x, y, count, 1);
+		if (overlap.empty()) {
+			std::fill_n(out, count, CellState::Dead);
+			return;
+		}
+
+		std::fill_n(out, overlap.areaX, CellState::Dead);
+		for (int done = 0; done < overlap.width;) {
+			int length;
+			CellState const* const src = runAt(overlap.boardX + done, overlap.boardY, length);
+			int const n = std::min(length, overlap.width - done);
+			std::copy_n(src, n, out + overlap.areaX + done);
+			done += n;
 		}
+		std::fill(out + overlap.areaX + overlap.width, out + count, CellState::Dead);
 	}
 
-	int GameOfLife::livingNeighborsOf(int const x, int const y) const {
-		int count{ 0 };
+	void GameOfLife::stamp(GameOfLife const& pattern, int const x, int const y, StampMode const mode) {
+		Overlap const overlap = clip(m_width, m_height, x, y, pattern.m_width, pattern.m_height);
+		if (overlap.empty())
+			return;
 
-		// pattern matching, destructuring, in C++: structured binding
-		// range-for
-		for (auto const[dx, dy] : neighbors) {
-			int const nx = x + dx;
-			int const ny = y + dy;
+		for (int row = 0; row < overlap.height; ++row) {
+			forEachPiece(
+				overlap.width,
+				[&](int const offset, int& length) { return runAt(overlap.boardX + offset, overlap.boardY + row, length); },
+				[&](int const offset, int& length) { return pattern.runAt(overlap.areaX + offset, overlap.areaY + row, length); },
+				[mode](CellState* dst, CellState const* src, int const n) {
+					switch (mode) {
+					case StampMode::Overwrite:
+						std::copy_n(src, n, dst);
+						break;
+					case StampMode::Or:
+						combineRow(dst, src, n, [](Word lhs, Word rhs) { return lhs | rhs; });
+						break;
+					case StampMode::Xor:
+						combineRow(dst, src, n, [](Word lhs, Word rhs) { return lhs ^ rhs; });
+						break;
+					}
+				}
+			);
+		}
+	}
 
-			if (operator()(nx, ny) == CellState::Alive)
-				++count;
+	GameOfLife GameOfLife::extract(Rect const& rect) const {
+		GameOfLife result{ rect.width, rect.height, Layout::RowMajor, m_resource };
+		for (int row = 0; row < rect.height; ++row) {
+			int length;
+			readRow(rect.x, rect.y + row, rect.width, result.runAt(0, row, length));
 		}
-		return count;
+		return result;
+	}
+
+	std::int64_t GameOfLife::countAlive() const {
+		// the cells of partial tiles outside of the board are always dead
+		return countRow(m_cells.data(), m_cells.data(), m_cells.size());
+	}
+
+	std::int64_t GameOfLife::countAlive(GameOfLife const& mask, int const x, int const y) const {
+		Overlap const overlap = clip(m_width, m_height, x, y, mask.m_width, mask.m_height);
+		if (overlap.empty())
+			return 0;
+
+		std::int64_t result{ 0 };
+		for (int row = 0; row < overlap.height; ++row) {
+			forEachPiece(
+				overlap.width,
+				[&](int const offset, int& length) { return runAt(overlap.boardX + offset, overlap.boardY + row, length); },
+				[&](int const offset, int& length) { return mask.runAt(overlap.areaX + offset, overlap.areaY + row, length); },
+				[&result](CellState const* lhs, CellState const* rhs, int const n) { result += countRow(lhs, rhs, static_cast<std::size_t>(n)); }
+			);
+		}
+		return result;
+	}
+
+	void GameOfLife::step() {
+		step(m_workers);
+	}
+
+	void GameOfLife::step(int const workers) {
+		if (workers == m_workers) {
+			step(*m_bandWorkers);
+		}
+		else {
+			BandWorkers bandWorkers{ workers };
+			step(bandWorkers);
+		}
+	}
+
+	void GameOfLife::step(BandWorkers& workers) {
+		if (m_layout == Layout::Tiled)
+			stepTiled(workers);
+		else
+			stepLattice<Moore>(m_cells.data(), m_next.data(), m_width, m_height, conway, workers);
+		std::swap(m_cells, m_next);
+	}
+
+	void GameOfLife::stepTiled(BandWorkers& workers) {
+		// every tile is computed on a copy including the surrounding ring of cells,
+		// so the row-wise kernel can run on it without knowing about tiles
+		constexpr int window = tileSize + 2;
+
+		forEachBand(tilesFor(m_height), workers, [this](int const tyBegin, int const tyEnd) {
+			std::array<CellState, window * window> src;
+			std::array<CellState, window * window> dst;
+
+			for (int ty = tyBegin; ty < tyEnd; ++ty) {
+				for (int tx = 0; tx < m_tilesX; ++tx) {
+					int const x0 = tx * tileSize;
+					int const y0 = ty * tileSize;
+					int const width = std::min(tileSize, m_width - x0);
+					int const height = std::min(tileSize, m_height - y0);
+
+					// only the rows of partial tiles which are inside of the board are computed
+					for (int row = 0; row < height + 2; ++row) {
+						readRow(x0 - 1, y0 - 1 + row, window, src.data() + row * window);
+					}
+
+					stepRows<Moore>(src.data(), dst.data(), window, height + 2, 1, height + 1, conway);
+
+					for (int row = 0; row < height; ++row) {
+						std::copy_n(dst.data() + (row + 1) * window + 1, width, m_next.data() + index(x0, y0 + row));
+					}
+				}
+			}
+		});
 	}
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "band_workers.hxx"
+
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <random>
 #include <type_traits>
 
@@ -14,7 +19,7 @@ enum Coordinate {
 };
 */
 
-#include <vector>
+#include <array>
 
 namespace workshop {
 	enum class CellState : std::uint8_t {
@@ -41,6 +46,32 @@ namespace workshop {
 	using CellStateT = std::underlying_type_t<CellState>;
 	*/
 
+	enum class StampMode {
+		Overwrite,
+		Or,
+		Xor,
+	};
+
+	/**
+	 * RowMajor stores the cells line by line.
+	 * Tiled stores square tiles of GameOfLife::tileSize cells line by line, each tile being contiguous,
+	 * so the rows above and below a cell are close by, no matter how wide the board is.
+	 * This pays off for small regions of boards much wider than a page, like counting the cells
+	 * under a mask (see BM_window). Stepping the whole board streams through the rows anyway
+	 * and is faster with RowMajor.
+	 */
+	enum class Layout {
+		RowMajor,
+		Tiled,
+	};
+
+	struct Rect final {
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
 	class GameOfLife final {
 	public:
 		// this is what vector<bool> does when using the non-const index operator
@@ -62,20 +93,115 @@ namespace workshop {
 			GameOfLife& m_game;
 		};
 
-		GameOfLife(int width, int height);
+		// a tile of 64 x 64 cells fills exactly one 4 KiB page
+		static constexpr int tileSize = 64;
+
+		/**
+		 * @brief GameOfLife creates a board with all cells dead.
+		 * @param resource Where the cells are allocated, e.g. a huge_page_memory_resource for big boards.
+		 * @param workers The number of threads step() uses. They are kept alive, each pinned to its own
+		 * processor where supported, and initialize the cells in the same bands they compute, so with
+		 * first-touch placement every band ends up on the NUMA node of the thread computing it.
+		 */
+		GameOfLife(
+			int width, int height,
+			Layout layout = Layout::RowMajor,
+			std::pmr::memory_resource * resource = std::pmr::get_default_resource(),
+			int workers = 1
+		);
+
+		// copies use the resource and number of workers of other, but start their own threads
+		GameOfLife(GameOfLife const& other);
+		GameOfLife(GameOfLife&&) noexcept = default;
+		GameOfLife& operator = (GameOfLife const& other);
+		GameOfLife& operator = (GameOfLife&&) noexcept = default;
+		~GameOfLife() noexcept = default;
 
 		CellState operator() (int x, int y) const;
 		CellReference operator() (int x, int y);
 
 		int width() const;
 		int height() const;
-
+		Layout layout() const;
+
+		/**
+		 * @brief readRow copies count cells of row y, starting at column x, to out.
+		 * Cells outside of the board are read as dead cells.
+		 */
+		void readRow(int x, int y, int count, CellState* out) const;
+
+		/**
+		 * @brief stamp combines the given pattern into this board with its top left corner at (x, y).
+		 * Cells of the pattern falling outside of the board are clipped.
+		 * @param pattern The pattern to stamp.
+		 * @param x The column the left edge of the pattern is placed at (may be negative).
+		 * @param y The row the top edge of the pattern is placed at (may be negative).
+		 * @param mode How the pattern cells are combined with the cells already on the board.
+		 */
+		void stamp(GameOfLife const& pattern, int x, int y, StampMode mode = StampMode::Overwrite);
+
+		/**
+		 * @brief extract copies a rectangular region of the board.
+		 * @param rect The region to copy, parts outside of the board are read as dead cells.
+		 * @return A new board of the size of rect.
+		 */
+		GameOfLife extract(Rect const& rect) const;
+
+		/**
+		 * @brief countAlive counts the living cells on the whole board.
+		 */
+		std::int64_t countAlive() const;
+
+		/**
+		 * @brief countAlive counts the living cells under the living cells of mask,
+		 * with the top left corner of mask placed at (x, y).
+		 */
+		std::int64_t countAlive(GameOfLife const& mask, int x, int y) const;
+
+		/**
+		 * @brief step advances the board by one generation,
+		 * using the number of workers the board was created with.
+		 */
 		void step();
 
+		/**
+		 * @brief step advances the board by one generation.
+		 * @param workers The number of threads computing bands of rows in parallel.
+		 * Other numbers than the one the board was created with start threads just for this step.
+		 */
+		void step(int workers);
+
 	private:
+		// uninitialized storage for the cells, so the pages are not touched before they are used
+		class CellBuffer final {
+		public:
+			CellBuffer(std::size_t size, std::pmr::memory_resource * resource);
+			CellBuffer(CellBuffer&& other) noexcept;
+			CellBuffer& operator = (CellBuffer&& other) noexcept;
+			~CellBuffer() noexcept;
+
+			CellState* data() noexcept;
+			CellState const* data() const noexcept;
+			std::size_t size() const noexcept;
+
+			CellState& operator[] (std::size_t index) noexcept;
+			CellState operator[] (std::size_t index) const noexcept;
+
+		private:
+			std::pmr::memory_resource * m_resource;
+			CellState* m_data;
+			std::size_t m_size;
+		};
+
 		int m_width;
 		int m_height;
-		std::vector<CellState> m_cells;
+		Layout m_layout;
+		int m_tilesX;
+		int m_workers;
+		std::unique_ptr<BandWorkers> m_bandWorkers;
+		std::pmr::memory_resource * m_resource;
+		CellBuffer m_cells;
+		CellBuffer m_next;
 
 		void randomize() {
 
@@ -95,7 +221,22 @@ namespace workshop {
 			}
 		}
 
-		int livingNeighborsOf(int x, int y) const;
 		bool isInField(int const x, int const y) const;
+
+		std::size_t index(int x, int y) const;
+
+		// the number of rows (or rows of tiles) being split into bands for the workers
+		int bandRows() const;
+		// the storage of the rows (or rows of tiles) begin to end
+		std::array<std::size_t, 2> storageRange(int begin, int end) const;
+		// initializes both buffers, copying the cells of source if given, band by band from the workers
+		void firstTouch(GameOfLife const* source);
+
+		// the cell at (x, y) and the number of cells following it contiguously in the same row
+		CellState* runAt(int x, int y, int& length);
+		CellState const* runAt(int x, int y, int& length) const;
+
+		void step(BandWorkers& workers);
+		void stepTiled(BandWorkers& workers);
 	};
 }
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include "game_of_life.hxx"
+#include "huge_page_memory_resource.hxx"
+namespace w = workshop;
+
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+namespace {
+	w::huge_page_memory_resource hugePages{};
+
+	w::GameOfLife soup(
+		int const width, int const height,
+		w::Layout const layout,
+		std::pmr::memory_resource * const resource,
+		int const workers
+	) {
+		w::GameOfLife game{ width, height, layout, resource, workers };
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				if ((x * 7 + y * 13) % 5 < 2)
+					game(x, y) = w::CellState::Alive;
+			}
+		}
+		return game;
+	}
+
+	void BM_step(benchmark::State& state, w::Layout const layout, std::pmr::memory_resource * const resource) {
+		int const width = static_cast<int>(state.range(0));
+		int const height = static_cast<int>(state.range(1));
+		int const workers = static_cast<int>(state.range(2));
+		w::GameOfLife game = soup(width, height, layout, resource, workers);
+
+		for (auto _ : state) {
+			game.step();
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations() * width * height);
+	}
+
+	// the same number of cells, getting wider and wider
+	void boards(benchmark::internal::Benchmark* b) {
+		for (int const workers : { 1, 4 }) {
+			b->Args({ 2048, 2048, workers });
+			b->Args({ 1 << 14, 256, workers });
+			b->Args({ 1 << 18, 16, workers });
+			b->Args({ 8192, 8192, workers });
+			b->Args({ 1 << 16, 1024, workers });
+		}
+		b->ArgNames({ "width", "height", "workers" });
+		b->Unit(benchmark::kMillisecond);
+		b->UseRealTime();
+	}
+
+	// counts the cells under a tile sized mask at random places of a board much wider than a page,
+	// where a row-major window touches a page per row and a tiled one at most four pages
+	void BM_window(benchmark::State& state, w::Layout const layout) {
+		int const width = static_cast<int>(state.range(0));
+		int const height = static_cast<int>(state.range(1));
+		w::GameOfLife game = soup(width, height, layout, std::pmr::get_default_resource(), 1);
+
+		w::GameOfLife mask{ w::GameOfLife::tileSize, w::GameOfLife::tileSize };
+		for (int y = 0; y < mask.height(); ++y) {
+			for (int x = 0; x < mask.width(); ++x) {
+				mask(x, y) = w::CellState::Alive;
+			}
+		}
+
+		std::mt19937 gen{ 42u };
+		std::uniform_int_distribution<int> column{ 0, width - mask.width() };
+		std::uniform_int_distribution<int> row{ 0, height - mask.height() };
+		std::vector<std::array<int, 2>> places(4096u);
+		for (auto& place : places) {
+			place = { column(gen), row(gen) };
+		}
+
+		std::int64_t alive{ 0 };
+		for (auto _ : state) {
+			for (auto const [x, y] : places) {
+				alive += game.countAlive(mask, x, y);
+			}
+		}
+		benchmark::DoNotOptimize(alive);
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(places.size()) * mask.width() * mask.height());
+	}
+
+	void wideBoards(benchmark::internal::Benchmark* b) {
+		b->Args({ 2048, 2048 });
+		b->Args({ 1 << 15, 2048 });
+		b->Args({ 1 << 17, 512 });
+		b->ArgNames({ "width", "height" });
+		b->Unit(benchmark::kMillisecond);
+	}
+}
+
+BENCHMARK_CAPTURE(BM_step, rowMajor, w::Layout::RowMajor, std::pmr::get_default_resource())->Apply(boards);
+BENCHMARK_CAPTURE(BM_step, tiled, w::Layout::Tiled, std::pmr::get_default_resource())->Apply(boards);
+BENCHMARK_CAPTURE(BM_step, rowMajorHugePages, w::Layout::RowMajor, &hugePages)->Apply(boards);
+BENCHMARK_CAPTURE(BM_step, tiledHugePages, w::Layout::Tiled, &hugePages)->Apply(boards);
+BENCHMARK_CAPTURE(BM_window, rowMajor, w::Layout::RowMajor)->Apply(wideBoards);
+BENCHMARK_CAPTURE(BM_window, tiled, w::Layout::Tiled)->Apply(wideBoards);
+
+BENCHMARK_MAIN();
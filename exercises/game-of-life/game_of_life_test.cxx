@@ -160,3 +160,166 @@ INSTANTIATE_TEST_SUITE_P(
 		}
 	)
 );
+
+TEST_F(GameOfLifeTest, stampOverwritesRegion) {
+	auto game =
+		"XXXX\n"
+		"XXXX\n"
+		"XXXX\n"_g;
+
+	game.stamp(
+		" X\n"
+		"X \n"_g,
+		1, 1
+	);
+
+	EXPECT_EQ(
+		"XXXX\n"
+		"X XX\n"
+		"XX X\n",
+		stringify(game)
+	);
+}
+
+TEST_F(GameOfLifeTest, stampCombinesWithOrAndXor) {
+	auto const pattern =
+		"XX\n"
+		"X \n"_g;
+
+	auto ored =
+		" X \n"
+		"  X\n"_g;
+	ored.stamp(pattern, 0, 0, w::StampMode::Or);
+	EXPECT_EQ(
+		"XX \n"
+		"X X\n",
+		stringify(ored)
+	);
+
+	auto xored =
+		" X \n"
+		"  X\n"_g;
+	xored.stamp(pattern, 0, 0, w::StampMode::Xor);
+	EXPECT_EQ(
+		"X  \n"
+		"X X\n",
+		stringify(xored)
+	);
+}
+
+TEST_F(GameOfLifeTest, stampClipsAtBoardEdges) {
+	w::GameOfLife game{ 3, 3 };
+
+	auto const block =
+		"XX\n"
+		"XX\n"_g;
+
+	game.stamp(block, -1, -1);
+	game.stamp(block, 2, 2);
+	game.stamp(block, 5, 0);
+
+	EXPECT_EQ(
+		"X  \n"
+		"   \n"
+		"  X\n",
+		stringify(game)
+	);
+}
+
+TEST_F(GameOfLifeTest, stampCopiesWideRows) {
+	// wider than a single word, so both the word wise and the cell wise paths are used
+	w::GameOfLife pattern{ 19, 1 };
+	for (int x = 0; x < pattern.width(); x += 2) {
+		pattern(x, 0) = w::CellState::Alive;
+	}
+
+	w::GameOfLife game{ 21, 1 };
+	game.stamp(pattern, 1, 0, w::StampMode::Xor);
+	game.stamp(pattern, 2, 0, w::StampMode::Xor);
+
+	EXPECT_EQ(" XXXXXXXXXXXXXXXXXXXX\n", stringify(game));
+	EXPECT_EQ(20, game.countAlive());
+}
+
+TEST_F(GameOfLifeTest, extractCopiesRegion) {
+	auto const game =
+		"X   \n"
+		" XX \n"
+		"  XX\n"_g;
+
+	EXPECT_EQ(
+		"XX\n"
+		" X\n",
+		stringify(game.extract({ 1, 1, 2, 2 }))
+	);
+	EXPECT_EQ(
+		"   \n"
+		" X \n"
+		"  X\n",
+		stringify(game.extract({ -1, -1, 3, 3 }))
+	);
+	EXPECT_EQ(
+		"XX \n"
+		"   \n",
+		stringify(game.extract({ 2, 2, 3, 2 }))
+	);
+}
+
+TEST_F(GameOfLifeTest, countAliveUsesPatternAsMask) {
+	auto const game =
+		"XXX \n"
+		"X X \n"
+		"XXXX\n"_g;
+
+	auto const mask =
+		"XX\n"
+		" X\n"_g;
+
+	EXPECT_EQ(9, game.countAlive());
+	EXPECT_EQ(2, game.countAlive(mask, 0, 0));
+	EXPECT_EQ(2, game.countAlive(mask, 1, 1));
+	EXPECT_EQ(1, game.countAlive(mask, 3, 2));
+	EXPECT_EQ(0, game.countAlive(mask, 4, 0));
+}
+
+TEST_F(GameOfLifeTest, tiledLayoutBehavesLikeRowMajor) {
+	// not a multiple of the tile size, so there are partial tiles at the right and bottom edges
+	w::GameOfLife rowMajor{ 150, 70 };
+	w::GameOfLife tiled{ 150, 70, w::Layout::Tiled };
+	EXPECT_EQ(w::Layout::Tiled, tiled.layout());
+
+	for (int y = 0; y < rowMajor.height(); ++y) {
+		for (int x = 0; x < rowMajor.width(); ++x) {
+			if ((x * 7 + y * 13) % 5 < 2) {
+				rowMajor(x, y) = w::CellState::Alive;
+				tiled(x, y) = w::CellState::Alive;
+			}
+		}
+	}
+
+	for (int n = 0; n < 5; ++n) {
+		rowMajor.step();
+		tiled.step(n % 2 + 1);
+	}
+
+	EXPECT_EQ(stringify(rowMajor), stringify(tiled));
+	EXPECT_EQ(rowMajor.countAlive(), tiled.countAlive());
+}
+
+TEST_F(GameOfLifeTest, tiledLayoutStampsAcrossTiles) {
+	w::GameOfLife pattern{ 3, 3 };
+	pattern(0, 0) = w::CellState::Alive;
+	pattern(1, 1) = w::CellState::Alive;
+	pattern(2, 2) = w::CellState::Alive;
+
+	w::GameOfLife tiled{ 130, 130, w::Layout::Tiled };
+	int const edge = w::GameOfLife::tileSize - 1;
+	tiled.stamp(pattern, edge, edge);
+
+	EXPECT_EQ(w::CellState::Alive, tiled(edge, edge));
+	EXPECT_EQ(w::CellState::Alive, tiled(edge + 1, edge + 1));
+	EXPECT_EQ(w::CellState::Alive, tiled(edge + 2, edge + 2));
+	EXPECT_EQ(3, tiled.countAlive());
+	EXPECT_EQ(3, tiled.countAlive(pattern, edge, edge));
+	EXPECT_EQ(stringify(pattern), stringify(tiled.extract({ edge, edge, 3, 3 })));
+}
@@ -0,0 +1,121 @@
+#include "huge_page_memory_resource.hxx"
+
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+namespace workshop {
+	namespace {
+		std::size_t roundUp(std::size_t const bytes, std::size_t const multiple) {
+			return (bytes + multiple - 1u) / multiple * multiple;
+		}
+
+		constexpr std::size_t hugePageSize = huge_page_memory_resource::hugePageSize;
+
+		void* mapPages(std::size_t const bytes, HugePages const mode) {
+#if defined(_WIN32)
+			if (mode == HugePages::Explicit) {
+				// requires the "Lock pages in memory" privilege
+				if (void* const p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+					return p;
+			}
+			// parts of a reservation cannot be released, so a huge page more than needed is only reserved
+			// to find an aligned address, which is then allocated on its own. Another thread may take it
+			// in between, so this is retried a few times.
+			for (int attempt = 0; attempt < 8; ++attempt) {
+				void* const reserved = VirtualAlloc(nullptr, bytes + hugePageSize, MEM_RESERVE, PAGE_NOACCESS);
+				if (!reserved)
+					return nullptr;
+				std::uintptr_t const aligned = roundUp(reinterpret_cast<std::uintptr_t>(reserved), hugePageSize);
+				VirtualFree(reserved, 0, MEM_RELEASE);
+				if (void* const p = VirtualAlloc(reinterpret_cast<void*>(aligned), bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE))
+					return p;
+			}
+			return nullptr;
+#elif defined(__unix__) || defined(__APPLE__)
+#if defined(MAP_HUGETLB)
+			// these mappings are aligned to the huge page size by the kernel
+			if (mode == HugePages::Explicit) {
+				void* const p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+				if (p != MAP_FAILED)
+					return p;
+			}
+#endif
+			// a huge page more than needed is mapped, so the part in use can start at a huge page boundary,
+			// the pages before and after it are unmapped right away
+			std::size_t const mapped = bytes + hugePageSize;
+			void* const p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED)
+				return nullptr;
+
+			auto* const begin = static_cast<unsigned char*>(p);
+			auto* const aligned = reinterpret_cast<unsigned char*>(roundUp(reinterpret_cast<std::uintptr_t>(p), hugePageSize));
+			if (aligned != begin)
+				munmap(begin, static_cast<std::size_t>(aligned - begin));
+			if (aligned + bytes != begin + mapped)
+				munmap(aligned + bytes, static_cast<std::size_t>(begin + mapped - (aligned + bytes)));
+#if defined(MADV_HUGEPAGE)
+			// only a hint, the mapping is fine without it
+			madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+			return aligned;
+#else
+			static_cast<void>(bytes);
+			static_cast<void>(mode);
+			return nullptr;
+#endif
+		}
+
+		void unmapPages(void * const p, std::size_t const bytes) {
+#if defined(_WIN32)
+			static_cast<void>(bytes);
+			VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__unix__) || defined(__APPLE__)
+			munmap(p, bytes);
+#else
+			static_cast<void>(p);
+			static_cast<void>(bytes);
+#endif
+		}
+	}
+
+	huge_page_memory_resource::huge_page_memory_resource(
+		HugePages const mode,
+		std::size_t const threshold,
+		std::pmr::memory_resource * const upstream
+	)
+		: m_mode{mode}
+		, m_threshold{threshold}
+		, m_upstream{upstream ? upstream : std::pmr::get_default_resource()}
+	{}
+
+	void* huge_page_memory_resource::do_allocate(std::size_t const bytes, std::size_t const alignment) {
+		if (bytes < m_threshold)
+			return m_upstream->allocate(bytes, alignment);
+
+		if (alignment > hugePageSize)
+			throw std::bad_alloc{};
+
+		void* const p = mapPages(roundUp(bytes, hugePageSize), m_mode);
+		if (!p)
+			throw std::bad_alloc{};
+		return p;
+	}
+
+	void huge_page_memory_resource::do_deallocate(void * const p, std::size_t const bytes, std::size_t const alignment) {
+		if (bytes < m_threshold)
+			m_upstream->deallocate(p, bytes, alignment);
+		else
+			unmapPages(p, roundUp(bytes, hugePageSize));
+	}
+
+	bool huge_page_memory_resource::do_is_equal(std::pmr::memory_resource const& other) const noexcept {
+		return this == &other;
+	}
+}
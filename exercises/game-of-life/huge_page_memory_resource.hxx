@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace workshop {
+	enum class HugePages {
+		// ask the kernel to back the mapping by transparent huge pages where it can
+		Transparent,
+		// take pages from the reserved huge page pool, falling back to Transparent if it is empty
+		Explicit,
+	};
+
+	/**
+	 * @brief huge_page_memory_resource maps allocations of at least threshold bytes directly
+	 * from the operating system, backed by huge pages, and passes smaller ones on to upstream.
+	 * Mapped allocations start at a multiple of hugePageSize, so every huge page they span can be a whole one.
+	 *
+	 * The mapped memory is not touched here, so each page ends up on the NUMA node
+	 * of the thread writing to it first.
+	 */
+	class huge_page_memory_resource final : public std::pmr::memory_resource {
+	public:
+		static constexpr std::size_t hugePageSize = 2u * 1024u * 1024u;
+
+		explicit huge_page_memory_resource(
+			HugePages mode = HugePages::Transparent,
+			std::size_t threshold = hugePageSize,
+			std::pmr::memory_resource * upstream = nullptr
+		);
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+		HugePages m_mode;
+		std::size_t m_threshold;
+		std::pmr::memory_resource * m_upstream;
+	};
+}
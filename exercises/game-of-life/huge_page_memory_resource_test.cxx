@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+namespace t = testing;
+
+#include "game_of_life.hxx"
+#include "huge_page_memory_resource.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+namespace w = workshop;
+
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+
+TEST(HugePageMemoryResourceTest, passesSmallAllocationsUpstream) {
+	counting_memory_resource upstream{};
+	w::huge_page_memory_resource resource{ w::HugePages::Transparent, 1024u, &upstream };
+
+	void* const small = resource.allocate(100u);
+	EXPECT_EQ(1u, upstream.allocations());
+	resource.deallocate(small, 100u);
+	EXPECT_EQ(0u, upstream.bytes_in_use());
+
+	void* const large = resource.allocate(4096u);
+	EXPECT_EQ(1u, upstream.allocations());
+	resource.deallocate(large, 4096u);
+}
+
+TEST(HugePageMemoryResourceTest, mapsZeroedHugePageAlignedMemory) {
+	for (auto const mode : { w::HugePages::Transparent, w::HugePages::Explicit }) {
+		w::huge_page_memory_resource resource{ mode };
+
+		std::size_t const size = 3u * w::huge_page_memory_resource::hugePageSize + 1u;
+		auto* const p = static_cast<unsigned char*>(resource.allocate(size, 64u));
+		ASSERT_NE(nullptr, p);
+		EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(p) % w::huge_page_memory_resource::hugePageSize);
+		EXPECT_EQ(0u, p[0]);
+		EXPECT_EQ(0u, p[size - 1u]);
+
+		std::memset(p, 0xAB, size);
+		resource.deallocate(p, size, 64u);
+	}
+}
+
+TEST(HugePageMemoryResourceTest, gameOfLifeAllocatesFromTheGivenResource) {
+	counting_memory_resource resource{};
+	{
+		w::GameOfLife game{ 100, 50, w::Layout::RowMajor, &resource, 3 };
+		EXPECT_EQ(2u, resource.allocations());
+		EXPECT_EQ(2u * 100u * 50u, resource.bytes_in_use());
+
+		game(1, 0) = w::CellState::Alive;
+		game(1, 1) = w::CellState::Alive;
+		game(1, 2) = w::CellState::Alive;
+
+		w::GameOfLife const copy{ game };
+		EXPECT_EQ(4u, resource.allocations());
+
+		for (int n = 0; n < 3; ++n) {
+			game.step();
+		}
+		// stepping swaps between the two buffers without allocating
+		EXPECT_EQ(4u, resource.allocations());
+		EXPECT_EQ(3, game.countAlive());
+		EXPECT_EQ(w::CellState::Alive, game(0, 1));
+		EXPECT_EQ(w::CellState::Alive, copy(1, 0));
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(HugePageMemoryResourceTest, gameOfLifeOnHugePages) {
+	w::huge_page_memory_resource resource{};
+	w::GameOfLife game{ 2048, 1100, w::Layout::Tiled, &resource, 2 };
+
+	game(1000, 1000) = w::CellState::Alive;
+	game(1001, 1000) = w::CellState::Alive;
+	game(1002, 1000) = w::CellState::Alive;
+	game.step();
+
+	EXPECT_EQ(3, game.countAlive());
+	EXPECT_EQ(w::CellState::Alive, game(1001, 999));
+	EXPECT_EQ(w::CellState::Alive, game(1001, 1001));
+}
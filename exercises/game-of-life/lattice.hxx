@@ -0,0 +1,284 @@
+#pragma once
+
+#include "band_workers.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace workshop {
+	struct Offset final {
+		int dx;
+		int dy;
+	};
+
+	// the 8 surrounding cells
+	struct Moore final {
+		static constexpr std::array<Offset, 8> offsets{{
+			{-1, -1}, {0, -1}, {1, -1},
+			{-1, 0},           {1, 0},
+			{-1, 1},  {0, 1},  {1, 1},
+		}};
+	};
+
+	// the 4 orthogonally adjacent cells
+	struct VonNeumann final {
+		static constexpr std::array<Offset, 4> offsets{{
+			          {0, -1},
+			{-1, 0},           {1, 0},
+			          {0, 1},
+		}};
+	};
+
+	// hexagonal cells in axial coordinates, stored as a sheared rectangle
+	struct Hexagonal final {
+		static constexpr std::array<Offset, 6> offsets{{
+			          {0, -1}, {1, -1},
+			{-1, 0},           {1, 0},
+			{-1, 1},  {0, 1},
+		}};
+	};
+
+	// the (2 * Radius + 1)^2 - 1 cells of the surrounding square, as used by Larger than Life
+	template <int Radius>
+	struct MooreRadius final {
+		static_assert(Radius > 0, "the radius has to be positive");
+
+		static constexpr std::array<Offset, (2 * Radius + 1) * (2 * Radius + 1) - 1> offsets = [] {
+			std::array<Offset, (2 * Radius + 1) * (2 * Radius + 1) - 1> result{};
+			std::size_t n = 0u;
+			for (int dy = -Radius; dy <= Radius; ++dy) {
+				for (int dx = -Radius; dx <= Radius; ++dx) {
+					if (dx != 0 || dy != 0)
+						result[n++] = Offset{ dx, dy };
+				}
+			}
+			return result;
+		}();
+	};
+
+	/**
+	 * @brief LifeLike is a two state rule in B/S notation, e.g. B3/S23 is Conway's Game of Life.
+	 * Bit n of birth/survival is set if a cell is born/survives with n living neighbours.
+	 */
+	template <typename State>
+	struct LifeLike final {
+		std::uint32_t birth;
+		std::uint32_t survival;
+
+		bool isLive(State const state) const {
+			return state == static_cast<State>(1);
+		}
+
+		State operator() (State const self, int const liveNeighbours) const {
+			std::uint32_t const rule = isLive(self) ? survival : birth;
+			return static_cast<State>(liveNeighbours < 32 && ((rule >> liveNeighbours) & 1u));
+		}
+	};
+
+	/**
+	 * @brief Generations extends a B/S rule by dying states: 0 is dead, 1 is alive and
+	 * a cell not surviving goes through the states 2 to states - 1 before it is dead again.
+	 * Only living cells count as neighbours, e.g. Brian's Brain is B2/S/3.
+	 */
+	template <typename State = std::uint8_t>
+	struct Generations final {
+		std::uint32_t birth;
+		std::uint32_t survival;
+		int states;
+
+		bool isLive(State const state) const {
+			return state == static_cast<State>(1);
+		}
+
+		State operator() (State const self, int const liveNeighbours) const {
+			auto const has = [liveNeighbours](std::uint32_t const rule) {
+				return liveNeighbours < 32 && ((rule >> liveNeighbours) & 1u);
+			};
+
+			int const current = static_cast<int>(self);
+			if (current == 0)
+				return static_cast<State>(has(birth) ? 1 : 0);
+			if (current == 1 && has(survival))
+				return self;
+			return static_cast<State>(current + 1 < states ? current + 1 : 0);
+		}
+	};
+
+	/**
+	 * @brief LargerThanLife is a two state rule with ranges of living neighbours
+	 * instead of single counts, meant for large neighbourhoods like MooreRadius.
+	 */
+	template <typename State = std::uint8_t>
+	struct LargerThanLife final {
+		int birthMin;
+		int birthMax;
+		int survivalMin;
+		int survivalMax;
+
+		bool isLive(State const state) const {
+			return state == static_cast<State>(1);
+		}
+
+		State operator() (State const self, int const liveNeighbours) const {
+			bool const next = isLive(self)
+				? survivalMin <= liveNeighbours && liveNeighbours <= survivalMax
+				: birthMin <= liveNeighbours && liveNeighbours <= birthMax;
+			return static_cast<State>(next);
+		}
+	};
+
+	/**
+	 * @brief stepRows calculates the rows yBegin to yEnd of the next generation.
+	 * Cells outside of the field count as not living.
+	 *
+	 * Instead of visiting the neighbours of every single cell, whole rows of neighbour
+	 * counts are summed up per offset. These loops run over contiguous memory without
+	 * any branches, so the compiler can vectorize them, and the counts live on the stack.
+	 */
+	template <typename Neighbourhood, typename State, typename Rule>
+	void stepRows(
+		State const* src, State* dst,
+		int const width, int const height,
+		int const yBegin, int const yEnd,
+		Rule const& rule
+	) {
+		constexpr int chunkSize = 256;
+		std::array<int, chunkSize> counts;
+
+		for (int y = yBegin; y < yEnd; ++y) {
+			for (int x0 = 0; x0 < width; x0 += chunkSize) {
+				int const x1 = std::min(x0 + chunkSize, width);
+				std::fill_n(counts.begin(), x1 - x0, 0);
+
+				for (auto const [dx, dy] : Neighbourhood::offsets) {
+					int const ny = y + dy;
+					if (ny < 0 || ny >= height)
+						continue;
+
+					State const* row = src + static_cast<std::ptrdiff_t>(ny) * width;
+					int const begin = std::max(x0, -dx);
+					int const end = std::min(x1, width - dx);
+					for (int x = begin; x < end; ++x) {
+						counts[x - x0] += rule.isLive(row[x + dx]) ? 1 : 0;
+					}
+				}
+
+				State const* self = src + static_cast<std::ptrdiff_t>(y) * width;
+				State* next = dst + static_cast<std::ptrdiff_t>(y) * width;
+				for (int x = x0; x < x1; ++x) {
+					next[x] = rule(self[x], counts[x - x0]);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief forEachBand splits count rows into one band per worker and calls f(begin, end) for each of them.
+	 */
+	template <typename F>
+	void forEachBand(int const count, BandWorkers& workers, F f) {
+		workers.run(count, f);
+	}
+
+	/**
+	 * @brief stepLattice calculates the next generation of src into dst,
+	 * splitting the rows into bands processed by the given workers.
+	 */
+	template <typename Neighbourhood, typename State, typename Rule>
+	void stepLattice(
+		State const* src, State* dst,
+		int const width, int const height,
+		Rule const& rule,
+		BandWorkers& workers
+	) {
+		forEachBand(height, workers, [=, &rule](int const yBegin, int const yEnd) {
+			stepRows<Neighbourhood>(src, dst, width, height, yBegin, yEnd, rule);
+		});
+	}
+
+	/**
+	 * @brief Lattice is a cellular automaton on a finite rectangular field,
+	 * generic over the cell state, the neighbourhood and the transition rule.
+	 * Stepping swaps between two buffers and keeps the threads of the workers alive,
+	 * so it does not allocate once the first step with that number of workers is done.
+	 */
+	template <typename State, typename Neighbourhood, typename Rule>
+	class Lattice final {
+	public:
+		Lattice(int const width, int const height, Rule const rule = Rule{})
+			: m_width{width}
+			, m_height{height}
+			, m_rule{rule}
+			, m_cells(static_cast<std::size_t>(width) * height, State{})
+		{}
+
+		// copies start their own workers when they are stepped
+		Lattice(Lattice const& other)
+			: m_width{other.m_width}
+			, m_height{other.m_height}
+			, m_rule{other.m_rule}
+			, m_cells{other.m_cells}
+		{}
+
+		Lattice(Lattice&&) noexcept = default;
+
+		Lattice& operator = (Lattice const& other) {
+			if (this != &other) {
+				Lattice copy{ other };
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		Lattice& operator = (Lattice&&) noexcept = default;
+		~Lattice() noexcept = default;
+
+		State operator() (int const x, int const y) const {
+			if (!isInField(x, y))
+				return State{};
+
+			return m_cells[index(x, y)];
+		}
+
+		void set(int const x, int const y, State const state) {
+			if (isInField(x, y))
+				m_cells[index(x, y)] = state;
+		}
+
+		int width() const {
+			return m_width;
+		}
+
+		int height() const {
+			return m_height;
+		}
+
+		void step(int const workers = 1) {
+			m_next.resize(m_cells.size());
+			if (!m_workers || m_workers->workers() != std::max(workers, 1))
+				m_workers = std::make_unique<BandWorkers>(workers);
+			stepLattice<Neighbourhood>(m_cells.data(), m_next.data(), m_width, m_height, m_rule, *m_workers);
+			m_cells.swap(m_next);
+		}
+
+	private:
+		int m_width;
+		int m_height;
+		Rule m_rule;
+		std::vector<State> m_cells;
+		std::vector<State> m_next{};
+		std::unique_ptr<BandWorkers> m_workers{};
+
+		bool isInField(int const x, int const y) const {
+			return x >= 0 && y >= 0 && x < m_width && y < m_height;
+		}
+
+		std::size_t index(int const x, int const y) const {
+			return static_cast<std::size_t>(y) * m_width + x;
+		}
+	};
+}
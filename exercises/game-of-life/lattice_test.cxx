@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+namespace t = testing;
+
+#include "game_of_life.hxx"
+#include "lattice.hxx"
+namespace w = workshop;
+
+#include <cstdint>
+#include <string>
+
+namespace {
+	template <typename Lattice>
+	std::string stringify(Lattice const& lattice) {
+		std::string result{};
+		for (int y = 0; y < lattice.height(); ++y) {
+			for (int x = 0; x < lattice.width(); ++x) {
+				result += static_cast<char>('0' + static_cast<int>(lattice(x, y)));
+			}
+			result += "\n";
+		}
+		return result;
+	}
+
+	template <typename Lattice>
+	void fill(Lattice& lattice, char const* cells) {
+		int x = 0, y = 0;
+		for (char const* cp = cells; *cp; ++cp) {
+			if (*cp == '\n') {
+				++y;
+				x = 0;
+			}
+			else {
+				lattice.set(x++, y, static_cast<std::uint8_t>(*cp - '0'));
+			}
+		}
+	}
+}
+
+TEST(LatticeTest, mooreRadiusHasAllCellsOfTheSquare) {
+	EXPECT_EQ(8u, w::MooreRadius<1>::offsets.size());
+	EXPECT_EQ(24u, w::MooreRadius<2>::offsets.size());
+}
+
+TEST(LatticeTest, lifeLikeOnMooreIsConway) {
+	w::Lattice<std::uint8_t, w::Moore, w::LifeLike<std::uint8_t>> lattice{ 3, 3, { 1u << 3, (1u << 2) | (1u << 3) } };
+	fill(lattice,
+		"000\n"
+		"111\n"
+		"000\n");
+
+	lattice.step();
+
+	EXPECT_EQ(
+		"010\n"
+		"010\n"
+		"010\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, vonNeumannOnlyCountsOrthogonalNeighbours) {
+	// B1/S: every cell with exactly one orthogonal neighbour is born, nothing survives
+	w::Lattice<std::uint8_t, w::VonNeumann, w::LifeLike<std::uint8_t>> lattice{ 3, 3, { 1u << 1, 0u } };
+	fill(lattice,
+		"000\n"
+		"010\n"
+		"000\n");
+
+	lattice.step();
+
+	EXPECT_EQ(
+		"010\n"
+		"101\n"
+		"010\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, hexagonalHasSixNeighbours) {
+	w::Lattice<std::uint8_t, w::Hexagonal, w::LifeLike<std::uint8_t>> lattice{ 3, 3, { 1u << 1, 0u } };
+	fill(lattice,
+		"000\n"
+		"010\n"
+		"000\n");
+
+	lattice.step();
+
+	EXPECT_EQ(
+		"011\n"
+		"101\n"
+		"110\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, generationsGoThroughDyingStates) {
+	// Brian's Brain: B2/S/3
+	w::Lattice<std::uint8_t, w::Moore, w::Generations<>> lattice{ 4, 3, { 1u << 2, 0u, 3 } };
+	fill(lattice,
+		"0000\n"
+		"0110\n"
+		"0000\n");
+
+	lattice.step();
+	EXPECT_EQ(
+		"0110\n"
+		"0220\n"
+		"0110\n",
+		stringify(lattice)
+	);
+
+	lattice.step();
+	EXPECT_EQ(
+		"0220\n"
+		"1001\n"
+		"0220\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, largerThanLifeCountsTheWholeRadius) {
+	// B1..1/S: every cell with exactly one living neighbour within radius 2 is born
+	w::Lattice<std::uint8_t, w::MooreRadius<2>, w::LargerThanLife<>> lattice{ 6, 5, { 1, 1, 100, 100 } };
+	fill(lattice,
+		"000000\n"
+		"000000\n"
+		"001000\n"
+		"000000\n"
+		"000000\n");
+
+	lattice.step();
+
+	EXPECT_EQ(
+		"111110\n"
+		"111110\n"
+		"110110\n"
+		"111110\n"
+		"111110\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, largerThanLifeUsesNeighbourRanges) {
+	// B3..4/S: nothing survives
+	w::Lattice<std::uint8_t, w::MooreRadius<2>, w::LargerThanLife<>> lattice{ 5, 5, { 3, 4, 100, 100 } };
+	fill(lattice,
+		"10100\n"
+		"00000\n"
+		"10000\n"
+		"00000\n"
+		"00000\n");
+
+	lattice.step();
+
+	EXPECT_EQ(
+		"01000\n"
+		"11100\n"
+		"01100\n"
+		"00000\n"
+		"00000\n",
+		stringify(lattice)
+	);
+}
+
+TEST(LatticeTest, parallelStepMatchesSequentialStep) {
+	w::GameOfLife sequential{ 300, 97 };
+	for (int y = 0; y < sequential.height(); ++y) {
+		for (int x = 0; x < sequential.width(); ++x) {
+			if ((x * 7 + y * 13) % 5 < 2)
+				sequential(x, y) = w::CellState::Alive;
+		}
+	}
+	w::GameOfLife parallel{ sequential };
+
+	for (int n = 0; n < 5; ++n) {
+		sequential.step();
+		parallel.step(4);
+	}
+
+	for (int y = 0; y < sequential.height(); ++y) {
+		for (int x = 0; x < sequential.width(); ++x) {
+			ASSERT_EQ(sequential(x, y), parallel(x, y)) << "at " << x << ", " << y;
+		}
+	}
+}
+
+TEST(LatticeTest, copiesStepOnTheirOwn) {
+	w::Lattice<std::uint8_t, w::Moore, w::LifeLike<std::uint8_t>> lattice{ 5, 5, { 1u << 3, (1u << 2) | (1u << 3) } };
+	fill(lattice,
+		"00000\n"
+		"00000\n"
+		"01110\n"
+		"00000\n"
+		"00000\n"
+	);
+	lattice.step(2);
+
+	auto copy = lattice;
+	copy.step(3);
+	EXPECT_EQ(
+		"00000\n"
+		"00100\n"
+		"00100\n"
+		"00100\n"
+		"00000\n",
+		stringify(lattice)
+	);
+	EXPECT_EQ(
+		"00000\n"
+		"00000\n"
+		"01110\n"
+		"00000\n"
+		"00000\n",
+		stringify(copy)
+	);
+
+	lattice = copy;
+	lattice.step(2);
+	EXPECT_EQ(
+		"00000\n"
+		"00100\n"
+		"00100\n"
+		"00100\n"
+		"00000\n",
+		stringify(lattice)
+	);
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace workshop {
+	/**
+	 * @brief ConcurrentList is a lock-free stack (Treiber stack) several threads may push to and pop from at once.
+	 *
+	 * Items are addressed by 32 bit indices into segments that are never freed before the list is destroyed,
+	 * so a thread reading an item another thread just popped still reads valid memory. The head and the free
+	 * list pair the index with a 32 bit tag that changes with every update, which makes a compare and swap
+	 * against a head that was popped and pushed again in between fail (ABA problem).
+	 *
+	 * The memory resource must be safe to use from several threads, like the default resource is.
+	 */
+	template <typename T>
+	class ConcurrentList final {
+		using Index = std::uint32_t;
+		// index and tag
+		using Tagged = std::uint64_t;
+
+		static constexpr Index nil = ~Index{ 0 };
+		static constexpr std::size_t firstSegmentItems = 64u;
+		static constexpr std::size_t segmentCount = 26u;
+
+		static_assert(std::atomic<Tagged>::is_always_lock_free, "ConcurrentList needs 64 bit atomics");
+
+		struct Item final {
+			std::atomic<Index> next;
+			alignas(T) std::byte data[sizeof(T)];
+
+			T* value() noexcept {
+				return std::launder(reinterpret_cast<T*>(data));
+			}
+		};
+
+	public:
+		using value_type = T;
+
+		ConcurrentList() noexcept = default;
+
+		explicit ConcurrentList(std::pmr::memory_resource * resource) noexcept
+			: m_resource{resource}
+		{}
+
+		ConcurrentList(ConcurrentList const&) = delete;
+		ConcurrentList& operator = (ConcurrentList const&) = delete;
+
+		~ConcurrentList() noexcept {
+			for (Index index = indexOf(m_head.load(std::memory_order_acquire)); index != nil;) {
+				Item& item = at(index);
+				item.value()->~T();
+				index = item.next.load(std::memory_order_relaxed);
+			}
+
+			for (std::size_t segment = 0u; segment < segmentCount; ++segment) {
+				if (Item* const items = m_segments[segment].load(std::memory_order_acquire))
+					m_resource->deallocate(items, segmentSize(segment) * sizeof(Item), alignof(Item));
+			}
+		}
+
+		std::pmr::memory_resource * resource() const noexcept {
+			return m_resource;
+		}
+
+		/**
+		 * @brief empty tells whether the list was empty at some point during the call.
+		 */
+		bool empty() const noexcept {
+			return indexOf(m_head.load(std::memory_order_acquire)) == nil;
+		}
+
+		void push_front(T const& value) {
+			emplace_front(value);
+		}
+
+		void push_front(T&& value) {
+			emplace_front(std::move(value));
+		}
+
+		template <typename... Args>
+		void emplace_front(Args&&... args) {
+			Index const index = acquireItem();
+			Item& item = at(index);
+
+			try {
+				::new(static_cast<void*>(item.data)) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				push(m_free, index);
+				throw;
+			}
+
+			push(m_head, index);
+		}
+
+		/**
+		 * @brief pop_front removes the first element.
+		 * @return The removed element, or nothing if the list is empty.
+		 */
+		std::optional<T> pop_front() {
+			Index const index = pop(m_head);
+			if (index == nil)
+				return std::nullopt;
+
+			T* const element = at(index).value();
+			std::optional<T> value{ std::move(*element) };
+			element->~T();
+			push(m_free, index);
+			return value;
+		}
+
+	private:
+		std::pmr::memory_resource * m_resource{ std::pmr::get_default_resource() };
+		std::atomic<Tagged> m_head{ tagged(nil, 0u) };
+		// items no longer in use, recycled before new ones are taken
+		std::atomic<Tagged> m_free{ tagged(nil, 0u) };
+		// the number of items ever taken from the segments
+		std::atomic<std::size_t> m_used{ 0u };
+		// segment n holds firstSegmentItems << n items
+		std::array<std::atomic<Item*>, segmentCount> m_segments{};
+
+		static constexpr Tagged tagged(Index const index, std::uint32_t const tag) noexcept {
+			return (Tagged{ tag } << 32u) | index;
+		}
+
+		static constexpr Index indexOf(Tagged const value) noexcept {
+			return static_cast<Index>(value);
+		}
+
+		static constexpr std::uint32_t tagOf(Tagged const value) noexcept {
+			return static_cast<std::uint32_t>(value >> 32u);
+		}
+
+		static constexpr std::size_t segmentSize(std::size_t const segment) noexcept {
+			return firstSegmentItems << segment;
+		}
+
+		static std::size_t segmentOf(std::size_t const index, std::size_t& offset) noexcept {
+			// segment n starts at index firstSegmentItems * (2^n - 1)
+			std::size_t const position = index / firstSegmentItems + 1u;
+			std::size_t segment = 0u;
+			while ((position >> (segment + 1u)) != 0u)
+				++segment;
+			offset = index - firstSegmentItems * ((std::size_t{ 1 } << segment) - 1u);
+			return segment;
+		}
+
+		Item& at(Index const index) const noexcept {
+			std::size_t offset = 0u;
+			std::size_t const segment = segmentOf(index, offset);
+			return m_segments[segment].load(std::memory_order_acquire)[offset];
+		}
+
+		Index acquireItem() {
+			Index const recycled = pop(m_free);
+			if (recycled != nil)
+				return recycled;
+
+			std::size_t const index = m_used.fetch_add(1u, std::memory_order_relaxed);
+			std::size_t offset = 0u;
+			std::size_t const segment = segmentOf(index, offset);
+			if (segment >= segmentCount || index >= nil)
+				throw std::length_error{ "too many items in concurrent list" };
+
+			if (!m_segments[segment].load(std::memory_order_acquire)) {
+				auto* const items = static_cast<Item*>(m_resource->allocate(segmentSize(segment) * sizeof(Item), alignof(Item)));
+				for (std::size_t n = 0u; n < segmentSize(segment); ++n) {
+					::new(static_cast<void*>(items + n)) Item;
+					items[n].next.store(nil, std::memory_order_relaxed);
+				}
+
+				// another thread needing the same segment may have been faster
+				Item* expected = nullptr;
+				if (!m_segments[segment].compare_exchange_strong(expected, items, std::memory_order_acq_rel, std::memory_order_acquire))
+					m_resource->deallocate(items, segmentSize(segment) * sizeof(Item), alignof(Item));
+			}
+			return static_cast<Index>(index);
+		}
+
+		void push(std::atomic<Tagged>& top, Index const index) noexcept {
+			Item& item = at(index);
+			Tagged old = top.load(std::memory_order_relaxed);
+			do {
+				item.next.store(indexOf(old), std::memory_order_relaxed);
+			} while (!top.compare_exchange_weak(old, tagged(index, tagOf(old) + 1u), std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		Index pop(std::atomic<Tagged>& top) noexcept {
+			Tagged old = top.load(std::memory_order_acquire);
+			for (;;) {
+				Index const index = indexOf(old);
+				if (index == nil)
+					return nil;
+
+				// may already be outdated if another thread popped the item meanwhile,
+				// but then the tag changed and the exchange fails
+				Index const next = at(index).next.load(std::memory_order_relaxed);
+				if (top.compare_exchange_weak(old, tagged(next, tagOf(old) + 1u), std::memory_order_acquire, std::memory_order_acquire))
+					return index;
+			}
+		}
+	};
+}
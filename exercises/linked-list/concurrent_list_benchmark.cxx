@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "concurrent_list.hxx"
+#include "list.hxx"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+using workshop::ConcurrentList;
+using workshop::List;
+
+namespace {
+	// the way lists are shared between threads without ConcurrentList
+	class LockedList final {
+	public:
+		void push_front(std::int64_t const value) {
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			m_list.push_front(value);
+		}
+
+		std::optional<std::int64_t> pop_front() {
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			if (m_list.empty())
+				return std::nullopt;
+			return m_list.pop_front();
+		}
+
+	private:
+		std::mutex m_mutex;
+		List<std::int64_t> m_list;
+	};
+
+	template <typename Stack>
+	void BM_concurrent_push_pop(benchmark::State& state) {
+		// shared by all threads of the benchmark
+		static Stack stack{};
+		constexpr std::int64_t batch = 16;
+
+		for (auto _ : state) {
+			for (std::int64_t n = 0; n < batch; ++n) {
+				stack.push_front(n);
+			}
+			for (std::int64_t n = 0; n < batch; ++n) {
+				benchmark::DoNotOptimize(stack.pop_front());
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * batch * 2);
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_concurrent_push_pop, LockedList)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_concurrent_push_pop, ConcurrentList<std::int64_t>)->ThreadRange(1, 64)->UseRealTime();
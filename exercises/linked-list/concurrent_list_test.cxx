@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "concurrent_list.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using workshop::ConcurrentList;
+
+TEST(ConcurrentListTest, push_and_pop_front)
+{
+	ConcurrentList<std::string> texts{};
+	EXPECT_TRUE(texts.empty());
+	EXPECT_FALSE(texts.pop_front().has_value());
+
+	texts.push_front("alpha");
+	texts.emplace_front(3u, 'b');
+	EXPECT_FALSE(texts.empty());
+
+	EXPECT_EQ("bbb", texts.pop_front());
+	EXPECT_EQ("alpha", texts.pop_front());
+	EXPECT_TRUE(texts.empty());
+}
+
+TEST(ConcurrentListTest, recycles_items)
+{
+	counting_memory_resource resource{};
+	{
+		ConcurrentList<int> numbers{ &resource };
+		for (int round = 0; round < 100; ++round) {
+			for (int n = 0; n < 64; ++n) {
+				numbers.push_front(n);
+			}
+			while (numbers.pop_front()) {
+			}
+		}
+		EXPECT_EQ(1u, resource.allocations());
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(ConcurrentListTest, destroys_remaining_elements)
+{
+	auto const counter = std::make_shared<int>(0);
+	{
+		ConcurrentList<std::shared_ptr<int>> pointers{};
+		for (int n = 0; n < 100; ++n) {
+			pointers.push_front(counter);
+		}
+		pointers.pop_front();
+		EXPECT_EQ(100, counter.use_count());
+	}
+	EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(ConcurrentListTest, every_element_is_popped_exactly_once)
+{
+	constexpr int threads = 8;
+	constexpr int perThread = 20000;
+
+	ConcurrentList<int> numbers{};
+	std::vector<std::vector<int>> popped(threads);
+	std::vector<std::thread> workers{};
+
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&numbers, &popped, t] {
+			// pushing and popping at the same time, so items are recycled while other threads look at them
+			for (int n = 0; n < perThread; ++n) {
+				numbers.push_front(t * perThread + n);
+				if (n % 2 == 1) {
+					if (auto value = numbers.pop_front())
+						popped[t].push_back(*value);
+				}
+			}
+			while (auto value = numbers.pop_front()) {
+				popped[t].push_back(*value);
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	std::vector<int> all{};
+	for (auto const& values : popped) {
+		all.insert(all.end(), values.begin(), values.end());
+	}
+	std::sort(all.begin(), all.end());
+
+	ASSERT_EQ(static_cast<std::size_t>(threads * perThread), all.size());
+	for (int n = 0; n < threads * perThread; ++n) {
+		ASSERT_EQ(n, all[n]);
+	}
+	EXPECT_TRUE(numbers.empty());
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace workshop {
+	/**
+	 * @brief ListHook is embedded into objects to link them into an IntrusiveList.
+	 *
+	 * Copying an object does not copy its links, the copy starts out unlinked.
+	 */
+	template <typename T>
+	struct ListHook final {
+		ListHook() noexcept = default;
+
+		ListHook(ListHook const&) noexcept
+		{}
+
+		ListHook& operator = (ListHook const&) noexcept {
+			return *this;
+		}
+
+		~ListHook() noexcept {
+			assert(!linked() && "destroying an object still linked into a list");
+		}
+
+		bool linked() const noexcept {
+			return m_linked;
+		}
+
+	private:
+		template <typename U, ListHook<U> U::*> friend class IntrusiveList;
+
+		T* m_next{ nullptr };
+		// m_next is null for the last object too, so it cannot tell whether the object is linked
+		bool m_linked{ false };
+	};
+
+	/**
+	 * @brief IntrusiveList is a singly linked list of objects that carry their own links in a ListHook member,
+	 * so linking and unlinking never allocate. The list does not own the objects, they have to stay alive
+	 * while linked, and an object can only be in one list per hook at a time.
+	 *
+	 * Every hook knows whether it is linked, debug builds also assert that objects are not linked twice
+	 * and not destroyed while linked.
+	 */
+	template <typename T, ListHook<T> T::* Hook>
+	class IntrusiveList final {
+		static ListHook<T>& hookOf(T& value) noexcept {
+			return value.*Hook;
+		}
+
+		template <bool Const>
+		class Iterator final {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<Const, T const*, T*>;
+			using reference = std::conditional_t<Const, T const&, T&>;
+
+			Iterator() noexcept = default;
+
+			// iterator converts to const_iterator
+			template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+			Iterator(Iterator<OtherConst> const& other) noexcept
+				: m_value{other.m_value}
+			{}
+
+			reference operator * () const noexcept {
+				return *m_value;
+			}
+
+			pointer operator -> () const noexcept {
+				return m_value;
+			}
+
+			Iterator& operator ++ () noexcept {
+				m_value = hookOf(*m_value).m_next;
+				return *this;
+			}
+
+			Iterator operator ++ (int) noexcept {
+				Iterator const old{ *this };
+				++*this;
+				return old;
+			}
+
+			friend bool operator == (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return lhs.m_value == rhs.m_value;
+			}
+
+			friend bool operator != (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return lhs.m_value != rhs.m_value;
+			}
+
+		private:
+			friend class IntrusiveList;
+			template <bool> friend class Iterator;
+
+			explicit Iterator(T* const value) noexcept
+				: m_value{value}
+			{}
+
+			T* m_value{ nullptr };
+		};
+
+	public:
+		using value_type = T;
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		IntrusiveList() noexcept = default;
+
+		IntrusiveList(IntrusiveList const&) = delete;
+		IntrusiveList& operator = (IntrusiveList const&) = delete;
+
+		IntrusiveList(IntrusiveList&& other) noexcept
+			: m_head{std::exchange(other.m_head, nullptr)}
+			, m_tail{std::exchange(other.m_tail, nullptr)}
+			, m_size{std::exchange(other.m_size, 0u)}
+		{}
+
+		IntrusiveList& operator = (IntrusiveList&& other) noexcept {
+			if (this != &other) {
+				clear();
+				m_head = std::exchange(other.m_head, nullptr);
+				m_tail = std::exchange(other.m_tail, nullptr);
+				m_size = std::exchange(other.m_size, 0u);
+			}
+			return *this;
+		}
+
+		// unlinks the objects, they are not destroyed
+		~IntrusiveList() noexcept {
+			clear();
+		}
+
+		bool empty() const noexcept {
+			return m_size == 0u;
+		}
+
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+		iterator begin() noexcept {
+			return iterator{ m_head };
+		}
+
+		iterator end() noexcept {
+			return iterator{};
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator{ m_head };
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{};
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		void push_front(T& value) noexcept {
+			link(value);
+			hookOf(value).m_next = m_head;
+			m_head = &value;
+			if (!m_tail)
+				m_tail = &value;
+		}
+
+		void push_back(T& value) noexcept {
+			link(value);
+			if (m_tail)
+				hookOf(*m_tail).m_next = &value;
+			else
+				m_head = &value;
+			m_tail = &value;
+		}
+
+		/**
+		 * @brief insert_after links value behind position, which has to be in this list.
+		 * @return An iterator to value.
+		 */
+		iterator insert_after(const_iterator const position, T& value) noexcept {
+			T* const before = position.m_value;
+			link(value);
+			hookOf(value).m_next = std::exchange(hookOf(*before).m_next, &value);
+			if (before == m_tail)
+				m_tail = &value;
+			return iterator{ &value };
+		}
+
+		/**
+		 * @brief pop_front unlinks the first object.
+		 * @return The unlinked object.
+		 * @throws std::out_of_range if the list is empty.
+		 */
+		T& pop_front() {
+			if (!m_head)
+				throw std::out_of_range{ "popping from empty list" };
+
+			T& value = *m_head;
+			m_head = hookOf(value).m_next;
+			if (!m_head)
+				m_tail = nullptr;
+			unlink(value);
+			return value;
+		}
+
+		/**
+		 * @brief erase_after unlinks the object behind position.
+		 * @return An iterator to the object behind the unlinked one.
+		 */
+		iterator erase_after(const_iterator const position) noexcept {
+			T* const before = position.m_value;
+			T& value = *hookOf(*before).m_next;
+			hookOf(*before).m_next = hookOf(value).m_next;
+			if (&value == m_tail)
+				m_tail = before;
+			unlink(value);
+			return iterator{ hookOf(*before).m_next };
+		}
+
+		T& front() {
+			if (m_head)
+				return *m_head;
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		T const& front() const {
+			if (m_head)
+				return *m_head;
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		T& back() {
+			if (m_tail)
+				return *m_tail;
+			throw std::out_of_range{ "accessing back of empty list" };
+		}
+
+		T const& back() const {
+			if (m_tail)
+				return *m_tail;
+			throw std::out_of_range{ "accessing back of empty list" };
+		}
+
+		void clear() noexcept {
+			while (m_head) {
+				T& value = *m_head;
+				m_head = hookOf(value).m_next;
+				unlink(value);
+			}
+			m_tail = nullptr;
+		}
+
+	private:
+		T* m_head{ nullptr };
+		T* m_tail{ nullptr };
+		std::size_t m_size{ 0u };
+
+		void link(T& value) noexcept {
+			assert(!hookOf(value).m_linked && "object is already linked into a list");
+			hookOf(value).m_linked = true;
+			hookOf(value).m_next = nullptr;
+			++m_size;
+		}
+
+		void unlink(T& value) noexcept {
+			hookOf(value).m_linked = false;
+			hookOf(value).m_next = nullptr;
+			--m_size;
+		}
+	};
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "intrusive_list.hxx"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+using workshop::IntrusiveList;
+using workshop::ListHook;
+
+namespace {
+	struct Request final {
+		int id;
+		std::string path;
+		ListHook<Request> queue{};
+		ListHook<Request> retry{};
+
+		Request(int const id, std::string path)
+			: id{id}
+			, path{std::move(path)}
+		{}
+	};
+
+	using RequestQueue = IntrusiveList<Request, &Request::queue>;
+	using RetryList = IntrusiveList<Request, &Request::retry>;
+
+	std::vector<int> idsOf(RequestQueue const& requests) {
+		std::vector<int> ids{};
+		std::transform(requests.begin(), requests.end(), std::back_inserter(ids), [](Request const& request) { return request.id; });
+		return ids;
+	}
+}
+
+TEST(IntrusiveListTest, queues_objects_in_order)
+{
+	Request requests[]{ { 1, "/a" }, { 2, "/b" }, { 3, "/c" } };
+
+	RequestQueue queue{};
+	EXPECT_TRUE(queue.empty());
+	for (auto& request : requests) {
+		queue.push_back(request);
+	}
+	EXPECT_EQ(3u, queue.size());
+	EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), idsOf(queue));
+	EXPECT_EQ(3, queue.back().id);
+	EXPECT_TRUE(requests[2].queue.linked());
+
+	EXPECT_EQ(&requests[0], &queue.pop_front());
+	EXPECT_FALSE(requests[0].queue.linked());
+	queue.push_front(requests[0]);
+	EXPECT_EQ(1, queue.front().id);
+
+	while (!queue.empty()) {
+		queue.pop_front();
+	}
+	EXPECT_THROW(queue.pop_front(), std::out_of_range);
+	EXPECT_THROW(queue.back(), std::out_of_range);
+}
+
+TEST(IntrusiveListTest, inserts_and_erases_after_positions)
+{
+	Request requests[]{ { 1, {} }, { 2, {} }, { 3, {} } };
+	{
+		RequestQueue queue{};
+		queue.push_back(requests[0]);
+		queue.push_back(requests[2]);
+		queue.insert_after(queue.begin(), requests[1]);
+		EXPECT_EQ(2, std::next(queue.begin())->id);
+		EXPECT_EQ(3, queue.back().id);
+
+		queue.erase_after(queue.begin());
+		EXPECT_EQ(2u, queue.size());
+		queue.erase_after(queue.begin());
+		EXPECT_EQ(1, queue.back().id);
+		queue.push_back(requests[1]);
+		EXPECT_EQ(2, queue.back().id);
+	}
+}
+
+TEST(IntrusiveListTest, objects_can_be_in_one_list_per_hook)
+{
+	Request requests[]{ { 1, {} }, { 2, {} } };
+	RequestQueue queue{};
+	RetryList retries{};
+
+	queue.push_back(requests[0]);
+	queue.push_back(requests[1]);
+	retries.push_front(requests[1]);
+
+	EXPECT_EQ(2u, queue.size());
+	EXPECT_EQ(2, retries.front().id);
+
+	RequestQueue moved{ std::move(queue) };
+	EXPECT_TRUE(queue.empty());
+	EXPECT_EQ((std::vector<int>{ 1, 2 }), idsOf(moved));
+
+	moved.clear();
+	retries.clear();
+	queue.push_back(requests[1]);
+	queue.clear();
+}
+
+TEST(IntrusiveListTest, copies_start_out_unlinked)
+{
+	Request original{ 1, "/a" };
+	RequestQueue queue{};
+	queue.push_back(original);
+
+	Request copy{ original };
+	EXPECT_FALSE(copy.queue.linked());
+	queue.push_back(copy);
+	EXPECT_EQ(2u, queue.size());
+	queue.clear();
+}
+
+#ifndef NDEBUG
+TEST(IntrusiveListDeathTest, catches_double_insertion)
+{
+	Request request{ 1, {} };
+	RequestQueue queue{};
+	RequestQueue other{};
+	queue.push_back(request);
+
+	EXPECT_TRUE(request.queue.linked());
+	EXPECT_DEATH(queue.push_back(request), "already linked");
+	EXPECT_DEATH(other.push_front(request), "already linked");
+
+	queue.clear();
+	EXPECT_FALSE(request.queue.linked());
+}
+#endif
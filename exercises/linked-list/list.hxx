@@ -2,11 +2,18 @@
 
 #include <cstddef>
 
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <type_traits>
 #include <stdexcept>
 #include <iostream>
+#include <utility>
+
+#include "node_pool.hxx"
 
 // ODR - One Definition Rule
 // apparently in classes inline is not necessary
@@ -33,28 +40,140 @@ inline void foo() {
 }
 
 namespace workshop {
+	/**
+	 * @brief List is a singly linked list, allocating its items from a std::pmr::memory_resource,
+	 * e.g. a node_pool_resource to recycle the items instead of going to the heap every time.
+	 *
+	 * Like std::forward_list it inserts and erases after a position, before_begin() being
+	 * the position in front of the first element.
+	 */
 	template <typename T>
 	class List final {
-		struct Item final {
+		struct Link {
+			Link* next;
+		};
+
+		// the link comes first, so a pointer to an item's link is a pointer to the item
+		struct Item final : Link {
 			T data;
-			std::unique_ptr<Item> next;
 
-			Item(T const& data, std::unique_ptr<Item> next)
-				noexcept(std::is_nothrow_copy_constructible_v<T>)
-				: data{data}
-				, next{std::move(next)}
+			template <typename... Args>
+			Item(Link* next, Args&&... args)
+				noexcept(std::is_nothrow_constructible_v<T, Args&&...>)
+				: Link{next}
+				, data(std::forward<Args>(args)...)
 			{}
 		};
 
+		static Item* itemOf(Link* const link) noexcept {
+			return static_cast<Item*>(link);
+		}
+
+		template <bool Const>
+		class Iterator final {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<Const, T const*, T*>;
+			using reference = std::conditional_t<Const, T const&, T&>;
+
+			Iterator() noexcept = default;
+
+			// iterator converts to const_iterator
+			template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+			Iterator(Iterator<OtherConst> const& other) noexcept
+				: m_link{other.m_link}
+			{}
+
+			reference operator * () const noexcept {
+				return itemOf(m_link)->data;
+			}
+
+			pointer operator -> () const noexcept {
+				return &itemOf(m_link)->data;
+			}
+
+			Iterator& operator ++ () noexcept {
+				m_link = m_link->next;
+				return *this;
+			}
+
+			Iterator operator ++ (int) noexcept {
+				Iterator const old{ *this };
+				m_link = m_link->next;
+				return old;
+			}
+
+			friend bool operator == (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return lhs.m_link == rhs.m_link;
+			}
+
+			friend bool operator != (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return lhs.m_link != rhs.m_link;
+			}
+
+		private:
+			friend class List;
+			template <bool> friend class Iterator;
+
+			explicit Iterator(Link* const link) noexcept
+				: m_link{link}
+			{}
+
+			Link* m_link{ nullptr };
+		};
+
 	public:
+		using value_type = T;
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
 		inline List() noexcept = default;
 
-		List(std::initializer_list<T> init) {
+		explicit List(std::pmr::memory_resource * resource) noexcept
+			: m_resource{resource}
+		{}
+
+		// delegates, so the destructor frees the items already pushed if copying an element throws
+		List(std::initializer_list<T> init, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+			: List(resource)
+		{
 			for (auto n = init.size(); n--;) {
 				push_front(*(init.begin() + n));
 			}
 		}
 
+		List(List const&) = delete;
+		List& operator = (List const&) = delete;
+
+		// the items stay where they are, so the resource moves along with them
+		List(List&& other) noexcept
+			: m_resource{other.m_resource}
+			, m_before{std::exchange(other.m_before.next, nullptr)}
+			, m_tail{std::exchange(other.m_tail, nullptr)}
+			, m_size{std::exchange(other.m_size, 0u)}
+		{}
+
+		List& operator = (List&& other) noexcept {
+			if (this != &other) {
+				clear();
+				m_resource = other.m_resource;
+				m_before.next = std::exchange(other.m_before.next, nullptr);
+				m_tail = std::exchange(other.m_tail, nullptr);
+				m_size = std::exchange(other.m_size, 0u);
+			}
+			return *this;
+		}
+
+		~List() noexcept {
+			clear();
+		}
+
+		std::pmr::memory_resource * resource() const noexcept {
+			return m_resource;
+		}
+
 		bool empty() const noexcept {
 			return m_size == 0u;
 		}
@@ -63,29 +182,337 @@ namespace workshop {
 			return m_size;
 		}
 
+		iterator before_begin() noexcept {
+			return iterator{ &m_before };
+		}
+
+		const_iterator before_begin() const noexcept {
+			return const_iterator{ const_cast<Link*>(&m_before) };
+		}
+
+		iterator begin() noexcept {
+			return iterator{ m_before.next };
+		}
+
+		iterator end() noexcept {
+			return iterator{};
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator{ m_before.next };
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{};
+		}
+
+		const_iterator cbefore_begin() const noexcept {
+			return before_begin();
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
 		void push_front(T const& value) {
-			m_head = std::make_unique<Item>(value, std::move(m_head));
+			emplace_front(value);
+		}
+
+		void push_front(T&& value) {
+			emplace_front(std::move(value));
+		}
+
+		/**
+		 * @brief emplace_front constructs a new first element in place.
+		 * @return A reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_front(Args&&... args) {
+			return *emplace_after(before_begin(), std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief pop_front removes the first element.
+		 * @return The removed element, moved out of the list.
+		 * @throws std::out_of_range if the list is empty.
+		 */
+		T pop_front() {
+			if (!m_before.next)
+				throw std::out_of_range{ "popping from empty list" };
+
+			T value{ std::move(itemOf(m_before.next)->data) };
+			erase_after(before_begin());
+			return value;
+		}
+
+		T& front() {
+			if (m_before.next)
+				return itemOf(m_before.next)->data;
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		T const& front() const {
+			if (m_before.next)
+				return itemOf(m_before.next)->data;
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		iterator insert_after(const_iterator const position, T const& value) {
+			return emplace_after(position, value);
+		}
+
+		iterator insert_after(const_iterator const position, T&& value) {
+			return emplace_after(position, std::move(value));
+		}
+
+		/**
+		 * @brief emplace_after constructs a new element in place behind position.
+		 * @return An iterator to the new element.
+		 */
+		template <typename... Args>
+		iterator emplace_after(const_iterator const position, Args&&... args) {
+			Link* const link = position.m_link;
+			Item* const item = createItem(link->next, std::forward<Args>(args)...);
+			link->next = item;
+			if (!item->next)
+				m_tail = item;
 			++m_size;
+			return iterator{ item };
+		}
+
+		/**
+		 * @brief erase_after removes the element behind position.
+		 * @return An iterator to the element behind the removed one.
+		 */
+		iterator erase_after(const_iterator const position) noexcept {
+			Link* const link = position.m_link;
+			Item* const item = itemOf(link->next);
+			link->next = item->next;
+			if (item == m_tail)
+				m_tail = link == &m_before ? nullptr : itemOf(link);
+			destroyItem(item);
+			--m_size;
+			return iterator{ link->next };
 		}
 
-		void pop_front() {
-			if (m_head) {
-				m_head = std::move(m_head->next);
-				--m_size;
+		/**
+		 * @brief erase_after removes the elements between first and last, both excluded.
+		 * @return last
+		 */
+		iterator erase_after(const_iterator const first, const_iterator const last) noexcept {
+			while (first.m_link->next != last.m_link) {
+				erase_after(first);
 			}
-			else {
-				throw std::out_of_range{ "popping from empty list" };
+			return iterator{ last.m_link };
+		}
+
+		/**
+		 * @brief splice_after moves all elements of other behind position, relinking the items without copying them.
+		 * @throws std::invalid_argument if the lists use different memory resources.
+		 */
+		void splice_after(const_iterator const position, List& other) {
+			if (!other.empty())
+				splice_after(position, other, other.before_begin(), other.end());
+		}
+
+		void splice_after(const_iterator const position, List&& other) {
+			splice_after(position, other);
+		}
+
+		/**
+		 * @brief splice_after moves the element of other behind it behind position.
+		 */
+		void splice_after(const_iterator const position, List& other, const_iterator const it) {
+			const_iterator last{ it };
+			++last;
+			if (last != other.end())
+				splice_after(position, other, it, ++last);
+		}
+
+		/**
+		 * @brief splice_after moves the elements of other between first and last, both excluded, behind position.
+		 * @throws std::invalid_argument if the lists use different memory resources.
+		 */
+		void splice_after(const_iterator const position, List& other, const_iterator const first, const_iterator const last) {
+			if (*m_resource != *other.m_resource)
+				throw std::invalid_argument{ "splicing items from a different memory resource" };
+
+			Link* const before = first.m_link;
+			if (before->next == last.m_link || position.m_link == before)
+				return;
+
+			// counting is needed for size() anyway and finds the last moved item
+			std::size_t count = 1u;
+			Link* moved = before->next;
+			for (; moved->next != last.m_link; moved = moved->next) {
+				++count;
+			}
+
+			Link* const link = position.m_link;
+			if (link == moved)
+				return;
+
+			if (itemOf(moved) == other.m_tail)
+				other.m_tail = before == &other.m_before ? nullptr : itemOf(before);
+			other.m_size -= count;
+
+			Link* const spliced = before->next;
+			before->next = last.m_link;
+			moved->next = link->next;
+			link->next = spliced;
+			if (!moved->next)
+				m_tail = itemOf(moved);
+			m_size += count;
+		}
+
+		void sort() {
+			sort(std::less<>{});
+		}
+
+		/**
+		 * @brief sort orders the elements by relinking the items with a bottom-up merge sort,
+		 * which takes O(n log n) comparisons and no extra memory. Equal elements keep their order.
+		 */
+		template <typename Compare>
+		void sort(Compare less) {
+			for (std::size_t width = 1u; width < m_size; width *= 2u) {
+				Link* sorted = &m_before;
+				Link* rest = m_before.next;
+				while (rest) {
+					Link* const left = rest;
+					Link* const right = cut(left, width);
+					rest = cut(right, width);
+					sorted = merge(sorted, left, right, less);
+				}
+				m_tail = itemOf(sorted);
 			}
 		}
 
-		T front() const {
-			if (m_head)
-				return m_head->data;
-			throw std::out_of_range{ "accessing front of empty list" };
+		/**
+		 * @brief compact moves the elements into new items laid out in list order, so traversing them
+		 * walks memory front to back. With a node_pool_resource the items end up in one contiguous block,
+		 * otherwise they are allocated one after another from the resource.
+		 * Iterators and references to elements are invalidated.
+		 */
+		void compact() {
+			if (m_size < 2u)
+				return;
+
+			auto* const pool = dynamic_cast<node_pool_resource*>(m_resource);
+			auto* const block = pool
+				? static_cast<std::byte*>(pool->allocate_contiguous(sizeof(Item), alignof(Item), m_size))
+				: nullptr;
+			std::size_t const stride = node_pool_resource::block_size(sizeof(Item));
+
+			std::size_t moved = 0u;
+			for (Link* link = &m_before; link->next; link = link->next, ++moved) {
+				Item* const old = itemOf(link->next);
+				void* const memory = block
+					? block + moved * stride
+					: m_resource->allocate(sizeof(Item), alignof(Item));
+
+				try {
+					link->next = new(memory) Item(old->next, std::move(old->data));
+				}
+				catch (...) {
+					// the elements moved so far stay in their new items, the list remains intact
+					if (block) {
+						for (std::size_t n = moved; n < m_size; ++n) {
+							pool->deallocate(block + n * stride, sizeof(Item), alignof(Item));
+						}
+					}
+					else {
+						m_resource->deallocate(memory, sizeof(Item), alignof(Item));
+					}
+					throw;
+				}
+
+				if (old == m_tail)
+					m_tail = itemOf(link->next);
+				destroyItem(old);
+			}
+		}
+
+		/**
+		 * @brief clear removes all elements, one at a time and without recursion, so even long lists
+		 * cannot overflow the stack. Items of trivially destructible elements allocated from a
+		 * node_pool_resource go back to the pool as one chain in O(1).
+		 */
+		void clear() noexcept {
+			if constexpr (std::is_trivially_destructible_v<T>) {
+				// the items are already linked through their first member, just like the pool's free blocks
+				if (auto* const pool = dynamic_cast<node_pool_resource*>(m_resource); pool && m_before.next) {
+					pool->deallocate_chain(itemOf(m_before.next), m_tail, sizeof(Item), alignof(Item));
+					m_before.next = nullptr;
+				}
+			}
+
+			while (m_before.next) {
+				destroyItem(itemOf(std::exchange(m_before.next, m_before.next->next)));
+			}
+			m_tail = nullptr;
+			m_size = 0u;
 		}
 
 	private:
-		std::unique_ptr<Item> m_head{};
+		std::pmr::memory_resource * m_resource{ std::pmr::get_default_resource() };
+		// in front of the first item, so inserting at the front is no special case
+		Link m_before{ nullptr };
+		// only needed to hand all items to a pool at once
+		Item* m_tail{ nullptr };
 		std::size_t m_size{ 0u };
+
+		// splits the run starting at first after count links, returning the rest
+		static Link* cut(Link* first, std::size_t count) noexcept {
+			if (!first)
+				return nullptr;
+			while (--count && first->next) {
+				first = first->next;
+			}
+			return std::exchange(first->next, nullptr);
+		}
+
+		// appends the merged runs to sorted, returning the new last link
+		template <typename Compare>
+		static Link* merge(Link* sorted, Link* left, Link* right, Compare& less) {
+			while (left && right) {
+				if (less(itemOf(right)->data, itemOf(left)->data)) {
+					sorted->next = right;
+					right = right->next;
+				}
+				else {
+					sorted->next = left;
+					left = left->next;
+				}
+				sorted = sorted->next;
+			}
+
+			sorted->next = left ? left : right;
+			while (sorted->next) {
+				sorted = sorted->next;
+			}
+			return sorted;
+		}
+
+		template <typename... Args>
+		Item* createItem(Args&&... args) {
+			void* const memory = m_resource->allocate(sizeof(Item), alignof(Item));
+			try {
+				return new(memory) Item(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				m_resource->deallocate(memory, sizeof(Item), alignof(Item));
+				throw;
+			}
+		}
+
+		void destroyItem(Item* const item) noexcept {
+			item->~Item();
+			m_resource->deallocate(item, sizeof(Item), alignof(Item));
+		}
 	};
 }
@@ -0,0 +1,223 @@
+#include <benchmark/benchmark.h>
+
+#include "intrusive_list.hxx"
+#include "list.hxx"
+#include "node_pool.hxx"
+#include "persistent_list.hxx"
+#include "unrolled_list.hxx"
+
+#include <cstdint>
+#include <forward_list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using workshop::IntrusiveList;
+using workshop::List;
+using workshop::PersistentList;
+using workshop::UnrolledList;
+
+namespace {
+	template <typename Container>
+	void BM_push_pop(benchmark::State& state) {
+		auto const count = static_cast<std::int64_t>(state.range(0));
+		Container values{};
+
+		for (auto _ : state) {
+			for (std::int64_t n = 0; n < count; ++n) {
+				values.push_front(n);
+			}
+			while (!values.empty()) {
+				benchmark::DoNotOptimize(values.pop_front());
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	template <typename Container>
+	void BM_iterate(benchmark::State& state) {
+		auto const count = static_cast<std::int64_t>(state.range(0));
+		Container values{};
+		for (std::int64_t n = 0; n < count; ++n) {
+			values.push_front(n);
+		}
+
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::accumulate(values.begin(), values.end(), std::int64_t{ 0 }));
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_iterate_unrolled_for_each(benchmark::State& state) {
+		auto const count = static_cast<std::int64_t>(state.range(0));
+		UnrolledList<std::int64_t> values{};
+		for (std::int64_t n = 0; n < count; ++n) {
+			values.push_front(n);
+		}
+
+		for (auto _ : state) {
+			std::int64_t sum{ 0 };
+			values.for_each([&sum](std::int64_t const n) { sum += n; });
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	// building the list is not measured, only destroying it
+	template <typename T>
+	void teardown(benchmark::State& state, std::pmr::memory_resource * const resource) {
+		auto const count = static_cast<std::int64_t>(state.range(0));
+
+		for (auto _ : state) {
+			state.PauseTiming();
+			auto values = std::make_unique<List<T>>(resource);
+			for (std::int64_t n = 0; n < count; ++n) {
+				values->emplace_front();
+			}
+			state.ResumeTiming();
+
+			values.reset();
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	void BM_teardown_default_resource(benchmark::State& state) {
+		teardown<std::int64_t>(state, std::pmr::get_default_resource());
+	}
+
+	void BM_teardown_node_pool(benchmark::State& state) {
+		workshop::node_pool_resource pool{};
+		teardown<std::int64_t>(state, &pool);
+	}
+
+	// not trivially destructible, so the items are destroyed one at a time
+	void BM_teardown_node_pool_strings(benchmark::State& state) {
+		workshop::node_pool_resource pool{};
+		teardown<std::string>(state, &pool);
+	}
+
+	struct Request final {
+		std::int64_t id;
+		workshop::ListHook<Request> hook;
+	};
+
+	// requests living in an arena, queued through a list of pointers or their own hooks
+	void BM_queue_pointers(benchmark::State& state) {
+		std::vector<Request> requests(static_cast<std::size_t>(state.range(0)));
+		List<Request*> queue{};
+
+		for (auto _ : state) {
+			for (auto& request : requests) {
+				queue.push_front(&request);
+			}
+			std::int64_t sum{ 0 };
+			while (!queue.empty()) {
+				sum += queue.pop_front()->id;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_queue_intrusive(benchmark::State& state) {
+		std::vector<Request> requests(static_cast<std::size_t>(state.range(0)));
+		IntrusiveList<Request, &Request::hook> queue{};
+
+		for (auto _ : state) {
+			for (auto& request : requests) {
+				queue.push_back(request);
+			}
+			std::int64_t sum{ 0 };
+			while (!queue.empty()) {
+				sum += queue.pop_front().id;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// sorting relinks the items, leaving them all over the pool
+	void BM_iterate_scattered(benchmark::State& state, bool const compacted) {
+		workshop::node_pool_resource pool{};
+		List<std::int64_t> values{ &pool };
+		std::mt19937_64 random{ 42u };
+		for (std::int64_t n = 0; n < state.range(0); ++n) {
+			values.push_front(static_cast<std::int64_t>(random() >> 1u));
+		}
+		values.sort();
+		if (compacted)
+			values.compact();
+
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::accumulate(values.begin(), values.end(), std::int64_t{ 0 }));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// handing a snapshot to a worker and adding to it there
+	void BM_snapshot_vector(benchmark::State& state) {
+		std::vector<std::int64_t> values(static_cast<std::size_t>(state.range(0)));
+
+		for (auto _ : state) {
+			std::vector<std::int64_t> snapshot{ values };
+			snapshot.push_back(0);
+			benchmark::DoNotOptimize(snapshot.data());
+		}
+	}
+
+	void BM_snapshot_persistent(benchmark::State& state) {
+		PersistentList<std::int64_t> values{};
+		for (std::int64_t n = 0; n < state.range(0); ++n) {
+			values.push_front(n);
+		}
+
+		for (auto _ : state) {
+			PersistentList<std::int64_t> snapshot{ values };
+			benchmark::DoNotOptimize(&snapshot.emplace_front(0));
+		}
+	}
+
+	void BM_iterate_vector(benchmark::State& state) {
+		auto const count = static_cast<std::int64_t>(state.range(0));
+		std::vector<std::int64_t> values(static_cast<std::size_t>(count));
+		std::iota(values.begin(), values.end(), std::int64_t{ 0 });
+
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::accumulate(values.begin(), values.end(), std::int64_t{ 0 }));
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_push_pop, List<std::int64_t>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_push_pop, UnrolledList<std::int64_t>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(BM_iterate, std::forward_list<std::int64_t>)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_iterate, UnrolledList<std::int64_t>)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_iterate_unrolled_for_each)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_iterate_vector)->Range(1 << 10, 1 << 22);
+
+BENCHMARK(BM_queue_pointers)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_queue_intrusive)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_CAPTURE(BM_iterate_scattered, before_compact, false)->Range(1 << 10, 1 << 22);
+BENCHMARK_CAPTURE(BM_iterate_scattered, after_compact, true)->Range(1 << 10, 1 << 22);
+
+BENCHMARK(BM_snapshot_vector)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_snapshot_persistent)->Range(1 << 10, 1 << 20);
+
+BENCHMARK(BM_teardown_default_resource)->Arg(10'000'000)->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK(BM_teardown_node_pool)->Arg(10'000'000)->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK(BM_teardown_node_pool_strings)->Arg(10'000'000)->Unit(benchmark::kMillisecond)->Iterations(5);
+
+BENCHMARK_MAIN();
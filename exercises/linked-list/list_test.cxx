@@ -1,6 +1,20 @@
 #include <gtest/gtest.h>
 
 #include "list.hxx"
+#include "node_pool.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+#include "../../examples/throwing_copy.hxx"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using workshop::List;
 
@@ -70,3 +84,334 @@ INSTANTIATE_TEST_SUITE_P(
 	ListEmptySizeCorelationTestFixture,
 	::testing::Values(0u, 1u, 3u, 23u, 42u)
 );
+
+TEST(ListTest, allocates_items_from_resource)
+{
+	counting_memory_resource resource{};
+	{
+		List<int> numbers{ { 1, 2, 3 }, &resource };
+		EXPECT_EQ(&resource, numbers.resource());
+		EXPECT_EQ(3u, resource.allocations());
+
+		numbers.pop_front();
+		EXPECT_EQ(1u, resource.deallocations());
+
+		List<int> moved{ std::move(numbers) };
+		EXPECT_EQ(&resource, moved.resource());
+		EXPECT_EQ(2u, moved.size());
+		EXPECT_EQ(2, moved.front());
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(ListTest, frees_items_when_initialization_throws)
+{
+	counting_memory_resource resource{};
+	EXPECT_THROW((List<throwing_copy>{ { 1, 2, 3 }, &resource }), std::runtime_error);
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(ListTest, pooled_items_do_not_allocate_in_steady_state)
+{
+	counting_memory_resource upstream{};
+	workshop::node_pool_resource pool{ &upstream };
+	List<std::size_t> queue{ &pool };
+
+	for (std::size_t n = 0u; n < 100u; ++n) {
+		queue.push_front(n);
+	}
+	queue.clear();
+	std::size_t const warmedUp = upstream.allocations();
+
+	for (int round = 0; round < 100; ++round) {
+		for (std::size_t n = 0u; n < 100u; ++n) {
+			queue.push_front(n);
+		}
+		while (!queue.empty()) {
+			queue.pop_front();
+		}
+	}
+	EXPECT_EQ(warmedUp, upstream.allocations());
+	EXPECT_EQ(0u, upstream.deallocations());
+}
+
+TEST(ListTest, clear_hands_pooled_items_back_at_once)
+{
+	counting_memory_resource upstream{};
+	workshop::node_pool_resource pool{ &upstream };
+	List<int> numbers{ &pool };
+
+	for (int n = 0; n < 1000; ++n) {
+		numbers.push_front(n);
+	}
+	int const* const first = &numbers.front();
+	numbers.clear();
+	EXPECT_TRUE(numbers.empty());
+	EXPECT_THROW(numbers.front(), std::out_of_range);
+
+	// the whole chain is in front of the free list again, starting with the former first item
+	std::size_t const allocations = upstream.allocations();
+	numbers.push_front(42);
+	EXPECT_EQ(first, &numbers.front());
+	for (int n = 1; n < 1000; ++n) {
+		numbers.push_front(n);
+	}
+	EXPECT_EQ(allocations, upstream.allocations());
+	EXPECT_EQ(0u, upstream.deallocations());
+}
+
+TEST(ListTest, destroys_long_lists_without_recursion)
+{
+	workshop::node_pool_resource pool{};
+	{
+		List<std::string> texts{ &pool };
+		for (int n = 0; n < 1'000'000; ++n) {
+			texts.emplace_front();
+		}
+	}
+	{
+		List<int> numbers{};
+		for (int n = 0; n < 1'000'000; ++n) {
+			numbers.push_front(n);
+		}
+		EXPECT_EQ(1'000'000u, numbers.size());
+	}
+}
+
+TEST(ListTest, moves_elements_in_and_out)
+{
+	List<std::string> texts{};
+	std::string text(100u, 'x');
+
+	texts.push_front(std::move(text));
+	EXPECT_TRUE(text.empty());
+
+	std::string const copied(50u, 'y');
+	texts.push_front(copied);
+	EXPECT_EQ(50u, copied.size());
+
+	std::string const popped = texts.pop_front();
+	EXPECT_EQ(copied, popped);
+	EXPECT_EQ(100u, texts.pop_front().size());
+	EXPECT_TRUE(texts.empty());
+}
+
+TEST(ListTest, emplace_front_constructs_in_place)
+{
+	List<std::string> texts{};
+
+	std::string& emplaced = texts.emplace_front(3u, 'z');
+	EXPECT_EQ("zzz", emplaced);
+	EXPECT_EQ(&emplaced, &texts.front());
+
+	texts.front() += "!";
+	EXPECT_EQ("zzz!", texts.front());
+}
+
+TEST(ListTest, supports_move_only_elements)
+{
+	List<std::unique_ptr<int>> pointers{};
+	pointers.push_front(std::make_unique<int>(23));
+	pointers.emplace_front(new int{ 42 });
+
+	EXPECT_EQ(42, *pointers.front());
+	std::unique_ptr<int> const popped = pointers.pop_front();
+	EXPECT_EQ(42, *popped);
+	EXPECT_EQ(23, *pointers.front());
+}
+
+TEST(ListTest, propagates_noexcept)
+{
+	static_assert(std::is_nothrow_move_constructible_v<List<std::string>>);
+	static_assert(std::is_nothrow_move_assignable_v<List<std::string>>);
+	static_assert(!std::is_copy_constructible_v<List<std::string>>);
+	static_assert(std::is_same_v<int&, decltype(std::declval<List<int>&>().front())>);
+	static_assert(std::is_same_v<int const&, decltype(std::declval<List<int> const&>().front())>);
+	static_assert(std::is_same_v<int, decltype(std::declval<List<int>&>().pop_front())>);
+}
+
+TEST(ListTest, iterates_with_standard_algorithms)
+{
+	List<int> numbers{ 3, 1, 4, 1, 5 };
+
+	std::vector<int> visited{};
+	for (int const n : numbers) {
+		visited.push_back(n);
+	}
+	EXPECT_EQ((std::vector<int>{ 3, 1, 4, 1, 5 }), visited);
+
+	EXPECT_EQ(14, std::accumulate(numbers.cbegin(), numbers.cend(), 0));
+	EXPECT_EQ(2, std::count(numbers.begin(), numbers.end(), 1));
+	EXPECT_EQ(4, *std::find(numbers.begin(), numbers.end(), 4));
+
+	std::transform(numbers.begin(), numbers.end(), numbers.begin(), [](int n) { return n * 2; });
+	List<int>::const_iterator const first = numbers.begin();
+	EXPECT_EQ(6, *first);
+	EXPECT_EQ(5, std::distance(numbers.begin(), numbers.end()));
+}
+
+TEST(ListTest, inserts_and_erases_after_positions)
+{
+	List<std::string> texts{};
+	auto it = texts.insert_after(texts.before_begin(), "b");
+	it = texts.insert_after(it, "d");
+	texts.insert_after(texts.before_begin(), "a");
+	texts.emplace_after(texts.begin(), 1u, 'c');
+	EXPECT_EQ((std::vector<std::string>{ "a", "c", "b", "d" }), std::vector<std::string>(texts.begin(), texts.end()));
+	EXPECT_EQ(4u, texts.size());
+
+	auto const next = texts.erase_after(texts.begin());
+	EXPECT_EQ("b", *next);
+	texts.erase_after(next);
+	EXPECT_EQ((std::vector<std::string>{ "a", "b" }), std::vector<std::string>(texts.begin(), texts.end()));
+
+	// appending after the last element after erasing it still works
+	texts.insert_after(next, "e");
+	EXPECT_EQ("e", *std::next(texts.begin(), 2));
+
+	EXPECT_EQ(texts.end(), texts.erase_after(texts.before_begin(), texts.end()));
+	EXPECT_TRUE(texts.empty());
+	EXPECT_EQ(texts.begin(), texts.end());
+}
+
+TEST(ListTest, splices_without_copying)
+{
+	List<int> numbers{ 1, 2, 3 };
+	List<int> others{ 10, 20, 30, 40 };
+	int const* const twenty = &*std::next(others.begin());
+
+	// 20 and 30 behind 1
+	numbers.splice_after(numbers.begin(), others, others.begin(), std::next(others.begin(), 3));
+	EXPECT_EQ((std::vector<int>{ 1, 20, 30, 2, 3 }), std::vector<int>(numbers.begin(), numbers.end()));
+	EXPECT_EQ((std::vector<int>{ 10, 40 }), std::vector<int>(others.begin(), others.end()));
+	EXPECT_EQ(twenty, &*std::next(numbers.begin()));
+	EXPECT_EQ(5u, numbers.size());
+	EXPECT_EQ(2u, others.size());
+
+	// 40 to the front
+	numbers.splice_after(numbers.before_begin(), others, others.begin());
+	EXPECT_EQ(40, numbers.front());
+	EXPECT_EQ(1u, others.size());
+
+	// the rest to the back
+	numbers.splice_after(std::next(numbers.begin(), 5), std::move(others));
+	EXPECT_EQ((std::vector<int>{ 40, 1, 20, 30, 2, 3, 10 }), std::vector<int>(numbers.begin(), numbers.end()));
+	EXPECT_TRUE(others.empty());
+
+	workshop::node_pool_resource pool{};
+	List<int> pooled{ { 7 }, &pool };
+	EXPECT_THROW(numbers.splice_after(numbers.before_begin(), pooled), std::invalid_argument);
+}
+
+TEST(ListTest, sorts_by_relinking_items)
+{
+	std::mt19937 random{ 42u };
+	std::uniform_int_distribution<int> values{ 0, 999 };
+
+	workshop::node_pool_resource pool{};
+	List<std::pair<int, int>> pairs{ &pool };
+	std::vector<std::pair<int, int>> expected{};
+	for (int n = 0; n < 10'000; ++n) {
+		// the second member is unique, so it tells whether equal keys kept their order
+		pairs.emplace_front(values(random), n);
+		expected.insert(expected.begin(), pairs.front());
+	}
+	auto const* const first = &pairs.front();
+
+	auto const byKey = [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; };
+	pairs.sort(byKey);
+	std::stable_sort(expected.begin(), expected.end(), byKey);
+	EXPECT_EQ(expected, (std::vector<std::pair<int, int>>(pairs.begin(), pairs.end())));
+	EXPECT_NE(pairs.end(), std::find_if(pairs.begin(), pairs.end(), [first](auto const& pair) { return &pair == first; }));
+
+	// the last item is known after sorting, appending and clearing into the pool still work
+	pairs.insert_after(std::next(pairs.before_begin(), 10'000), { 1000, 0 });
+	EXPECT_EQ(1000, std::next(pairs.begin(), 10'000)->first);
+	pairs.clear();
+
+	List<std::unique_ptr<int>> pointers{};
+	for (int n : { 3, 1, 2 }) {
+		pointers.push_front(std::make_unique<int>(n));
+	}
+	pointers.sort([](auto const& lhs, auto const& rhs) { return *lhs < *rhs; });
+	EXPECT_EQ(1, *pointers.pop_front());
+	EXPECT_EQ(2, *pointers.pop_front());
+	EXPECT_EQ(3, *pointers.pop_front());
+
+	List<int> single{ 1 };
+	single.sort();
+	EXPECT_EQ(1, single.front());
+}
+
+TEST(ListTest, compact_lays_out_items_in_list_order)
+{
+	workshop::node_pool_resource pool{};
+	List<int> numbers{ &pool };
+	for (int n = 0; n < 1000; ++n) {
+		numbers.push_front((n * 7919) % 1000);
+	}
+	numbers.sort();
+	numbers.compact();
+
+	EXPECT_EQ(1000u, numbers.size());
+	EXPECT_TRUE(std::is_sorted(numbers.begin(), numbers.end()));
+	EXPECT_EQ(499'500, std::accumulate(numbers.begin(), numbers.end(), 0));
+
+	auto const* previous = reinterpret_cast<std::byte const*>(&numbers.front());
+	for (auto it = std::next(numbers.begin()); it != numbers.end(); ++it) {
+		auto const* const current = reinterpret_cast<std::byte const*>(&*it);
+		ASSERT_EQ(previous + workshop::node_pool_resource::block_size(sizeof(void*) + sizeof(int)), current);
+		previous = current;
+	}
+
+	// the last item moved too
+	numbers.insert_after(std::next(numbers.before_begin(), 1000), 1000);
+	EXPECT_EQ(1000, *std::next(numbers.begin(), 1000));
+	numbers.clear();
+}
+
+TEST(ListTest, repeated_compact_does_not_grow_the_pool)
+{
+	counting_memory_resource upstream{};
+	workshop::node_pool_resource pool{ &upstream };
+	List<int> numbers{ &pool };
+	for (int n = 0; n < 10'000; ++n) {
+		numbers.push_front(n);
+	}
+
+	// the previous run is still in use while the items move to the next one,
+	// so the pool settles at two runs
+	numbers.compact();
+	numbers.compact();
+	std::size_t const footprint = upstream.bytes_in_use();
+	for (int n = 0; n < 5; ++n) {
+		numbers.compact();
+		EXPECT_EQ(footprint, upstream.bytes_in_use());
+	}
+
+	// runs go back to upstream with the next run once none of their blocks is in use
+	numbers.clear();
+	numbers.push_front(1);
+	numbers.push_front(2);
+	numbers.compact();
+	EXPECT_GT(footprint, upstream.bytes_in_use());
+	EXPECT_EQ(3, std::accumulate(numbers.begin(), numbers.end(), 0));
+}
+
+TEST(ListTest, compact_moves_elements)
+{
+	counting_memory_resource resource{};
+	{
+		List<std::unique_ptr<std::string>> texts{ &resource };
+		texts.push_front(std::make_unique<std::string>("b"));
+		texts.push_front(std::make_unique<std::string>("a"));
+		std::string const* const a = texts.front().get();
+
+		texts.compact();
+		EXPECT_EQ(4u, resource.allocations());
+		EXPECT_EQ(2u, resource.deallocations());
+		EXPECT_EQ(a, texts.front().get());
+		EXPECT_EQ("b", **std::next(texts.begin()));
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
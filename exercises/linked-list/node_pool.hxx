@@ -0,0 +1,282 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <utility>
+
+namespace workshop {
+	/**
+	 * @brief node_pool_resource hands out small blocks from size classes in steps of
+	 * node_pool_resource::granularity bytes, recycling deallocated blocks through one
+	 * free list per size class. Larger blocks and stricter alignments are passed on to upstream.
+	 *
+	 * Memory only goes back to upstream on release() or destruction, so once the pool is
+	 * warmed up allocating and deallocating nodes does not call upstream any more.
+	 * The exception are runs from allocate_contiguous, which go back once all their blocks are deallocated
+	 * and another run of the same block size is allocated.
+	 * Like std::pmr::unsynchronized_pool_resource it must not be used by several threads at once.
+	 */
+	class node_pool_resource final : public std::pmr::memory_resource {
+	public:
+		static constexpr std::size_t granularity = alignof(std::max_align_t);
+		static constexpr std::size_t maxBlockSize = 256u;
+
+		explicit node_pool_resource(std::pmr::memory_resource * upstream = nullptr) noexcept
+			: m_upstream{upstream ? upstream : std::pmr::get_default_resource()}
+		{}
+
+		node_pool_resource(node_pool_resource const&) = delete;
+		node_pool_resource& operator = (node_pool_resource const&) = delete;
+
+		~node_pool_resource() noexcept override {
+			release();
+		}
+
+		/**
+		 * @brief release gives all memory back to upstream, even blocks still in use.
+		 */
+		void release() noexcept {
+			while (m_chunks) {
+				Chunk* const chunk = m_chunks;
+				m_chunks = chunk->next;
+				m_upstream->deallocate(chunk, chunk->bytes, granularity);
+			}
+			while (m_runs) {
+				Run* const run = m_runs;
+				m_runs = run->next;
+				m_upstream->deallocate(run, run->bytes, granularity);
+			}
+			m_classes = {};
+		}
+
+		/**
+		 * @brief allocate_contiguous hands out count blocks for the given size and alignment that follow
+		 * each other block_size(bytes) apart, taken from a new run of exactly that size.
+		 * Every block can be deallocated on its own later and is recycled like any other block.
+		 * Before taking the new run from upstream, the runs of the same block size whose blocks are all
+		 * deallocated go back to upstream, so repeatedly replacing a run by a new one does not grow the pool.
+		 * Finding them sorts the free list of the size class, which takes O(n log n) for n free blocks.
+		 * @return The first block, or nullptr if blocks of that size or alignment are not pooled.
+		 */
+		void* allocate_contiguous(std::size_t const bytes, std::size_t const alignment, std::size_t const count) {
+			if (!pooled(bytes, alignment) || count == 0u)
+				return nullptr;
+
+			if (m_runs)
+				releaseUnusedRuns(sizeClassFor(bytes));
+
+			std::size_t const size = sizeof(Run) + count * block_size(bytes);
+			auto* const run = static_cast<Run*>(m_upstream->allocate(size, granularity));
+			run->bytes = size;
+			run->blocks = count;
+			run->free = 0u;
+
+			// kept in ascending order, like the free list when looking for unused runs
+			Run** link = &m_runs;
+			while (*link && std::less<>{}(*link, run)) {
+				link = &(*link)->next;
+			}
+			run->next = *link;
+			*link = run;
+			return run + 1;
+		}
+
+		/**
+		 * @brief deallocate_chain gives back a chain of blocks allocated with the same size and alignment at once.
+		 * Every block but the last has to start with a pointer to the next one, like the items of a singly linked list.
+		 * Pooled blocks are put in front of their free list in O(1), others are deallocated one at a time.
+		 */
+		void deallocate_chain(void * const first, void * const last, std::size_t const bytes, std::size_t const alignment) noexcept {
+			if (!pooled(bytes, alignment)) {
+				for (void* block = first;;) {
+					void* const next = *static_cast<void**>(block);
+					m_upstream->deallocate(block, bytes, alignment);
+					if (block == last)
+						break;
+					block = next;
+				}
+				return;
+			}
+
+			SizeClass& sizeClass = sizeClassFor(bytes);
+			static_cast<FreeBlock*>(last)->next = sizeClass.free;
+			sizeClass.free = static_cast<FreeBlock*>(first);
+		}
+
+		std::pmr::memory_resource * upstream_resource() const noexcept {
+			return m_upstream;
+		}
+
+		/**
+		 * @brief block_size is the size of the blocks handed out for requests of the given size,
+		 * which is also the distance between neighbouring blocks of a chunk.
+		 */
+		static constexpr std::size_t block_size(std::size_t const bytes) noexcept {
+			return bytes == 0u ? granularity : (bytes + granularity - 1u) / granularity * granularity;
+		}
+
+	private:
+		struct FreeBlock final {
+			FreeBlock* next;
+		};
+
+		// placed in front of the blocks of every chunk taken from upstream
+		struct alignas(granularity) Chunk final {
+			Chunk* next;
+			std::size_t bytes;
+		};
+
+		// placed in front of the blocks of every run from allocate_contiguous
+		struct alignas(granularity) Run final {
+			Run* next;
+			std::size_t bytes;
+			std::size_t blocks;
+			// the blocks found on the free list while looking for unused runs
+			std::size_t free;
+		};
+
+		struct SizeClass final {
+			FreeBlock* free = nullptr;
+			std::size_t nextChunkBlocks = 16u;
+		};
+
+		static constexpr std::size_t maxChunkBlocks = 1024u;
+
+		static bool pooled(std::size_t const bytes, std::size_t const alignment) noexcept {
+			return bytes <= maxBlockSize && alignment <= granularity;
+		}
+
+		SizeClass& sizeClassFor(std::size_t const bytes) noexcept {
+			return m_classes[block_size(bytes) / granularity - 1u];
+		}
+
+		static void* endOf(Run * const run) noexcept {
+			return reinterpret_cast<std::byte*>(run) + run->bytes;
+		}
+
+		// skips the runs ending at or before block, the runs being sorted
+		static Run* runFrom(Run * run, FreeBlock const* const block) noexcept {
+			while (run && !std::less<>{}(static_cast<void const*>(block), endOf(run))) {
+				run = run->next;
+			}
+			return run;
+		}
+
+		static bool contains(Run * const run, FreeBlock const* const block) noexcept {
+			return !std::less<>{}(static_cast<void const*>(block), static_cast<void*>(run + 1));
+		}
+
+		// merge sort, the list being split in halves by walking it at one and two blocks a step
+		static FreeBlock* sortedByAddress(FreeBlock * const list) noexcept {
+			if (!list || !list->next)
+				return list;
+
+			FreeBlock* middle = list;
+			for (FreeBlock* end = list->next; end && end->next; end = end->next->next) {
+				middle = middle->next;
+			}
+			FreeBlock* rhs = sortedByAddress(std::exchange(middle->next, nullptr));
+			FreeBlock* lhs = sortedByAddress(list);
+
+			FreeBlock before{ nullptr };
+			FreeBlock* last = &before;
+			while (lhs && rhs) {
+				FreeBlock*& lower = std::less<>{}(lhs, rhs) ? lhs : rhs;
+				last = last->next = lower;
+				lower = lower->next;
+			}
+			last->next = lhs ? lhs : rhs;
+			return before.next;
+		}
+
+		// gives the runs back whose blocks are all on the free list of sizeClass, taking their blocks off it
+		void releaseUnusedRuns(SizeClass& sizeClass) noexcept {
+			// both the runs and the free blocks are in ascending order, so they can be walked side by side
+			sizeClass.free = sortedByAddress(sizeClass.free);
+
+			Run* run = m_runs;
+			for (FreeBlock* block = sizeClass.free; block && (run = runFrom(run, block)); block = block->next) {
+				if (contains(run, block))
+					++run->free;
+			}
+
+			run = m_runs;
+			for (FreeBlock** link = &sizeClass.free; *link && (run = runFrom(run, *link));) {
+				if (contains(run, *link) && run->free == run->blocks)
+					*link = (*link)->next;
+				else
+					link = &(*link)->next;
+			}
+
+			for (Run** link = &m_runs; *link;) {
+				Run* const unused = *link;
+				if (unused->free == unused->blocks) {
+					*link = unused->next;
+					m_upstream->deallocate(unused, unused->bytes, granularity);
+				}
+				else {
+					unused->free = 0u;
+					link = &unused->next;
+				}
+			}
+		}
+
+		void refill(SizeClass& sizeClass, std::size_t const blockSize) {
+			std::size_t const blocks = sizeClass.nextChunkBlocks;
+			std::size_t const bytes = sizeof(Chunk) + blocks * blockSize;
+
+			auto* const chunk = static_cast<Chunk*>(m_upstream->allocate(bytes, granularity));
+			chunk->next = m_chunks;
+			chunk->bytes = bytes;
+			m_chunks = chunk;
+
+			// linked back to front, so the blocks are handed out in ascending order
+			auto* const first = reinterpret_cast<std::byte*>(chunk + 1);
+			for (std::size_t n = blocks; n--;) {
+				auto* const block = reinterpret_cast<FreeBlock*>(first + n * blockSize);
+				block->next = sizeClass.free;
+				sizeClass.free = block;
+			}
+
+			if (sizeClass.nextChunkBlocks < maxChunkBlocks)
+				sizeClass.nextChunkBlocks *= 2u;
+		}
+
+		void* do_allocate(std::size_t const bytes, std::size_t const alignment) override {
+			if (!pooled(bytes, alignment))
+				return m_upstream->allocate(bytes, alignment);
+
+			SizeClass& sizeClass = sizeClassFor(bytes);
+			if (!sizeClass.free)
+				refill(sizeClass, block_size(bytes));
+
+			FreeBlock* const block = sizeClass.free;
+			sizeClass.free = block->next;
+			return block;
+		}
+
+		void do_deallocate(void * const p, std::size_t const bytes, std::size_t const alignment) override {
+			if (!pooled(bytes, alignment)) {
+				m_upstream->deallocate(p, bytes, alignment);
+				return;
+			}
+
+			SizeClass& sizeClass = sizeClassFor(bytes);
+			auto* const block = static_cast<FreeBlock*>(p);
+			block->next = sizeClass.free;
+			sizeClass.free = block;
+		}
+
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+			return this == &other;
+		}
+
+		std::pmr::memory_resource * m_upstream;
+		std::array<SizeClass, maxBlockSize / granularity> m_classes{};
+		Chunk* m_chunks = nullptr;
+		// in ascending order, few at a time, usually up to two per compacted list
+		Run* m_runs = nullptr;
+	};
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "node_pool.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using workshop::node_pool_resource;
+
+TEST(NodePoolTest, recyclesDeallocatedBlocks)
+{
+	counting_memory_resource upstream{};
+	node_pool_resource pool{ &upstream };
+
+	void* const first = pool.allocate(24u, 8u);
+	EXPECT_EQ(1u, upstream.allocations());
+
+	pool.deallocate(first, 24u, 8u);
+	void* const second = pool.allocate(20u, 8u);
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(1u, upstream.allocations());
+
+	pool.deallocate(second, 20u, 8u);
+}
+
+TEST(NodePoolTest, handsOutNeighbouringBlocksInOrder)
+{
+	node_pool_resource pool{};
+
+	auto* const first = static_cast<std::byte*>(pool.allocate(24u, 8u));
+	auto* const second = static_cast<std::byte*>(pool.allocate(24u, 8u));
+	EXPECT_EQ(first + node_pool_resource::block_size(24u), second);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(first) % node_pool_resource::granularity);
+}
+
+TEST(NodePoolTest, passesLargeAndOveralignedBlocksUpstream)
+{
+	counting_memory_resource upstream{};
+	node_pool_resource pool{ &upstream };
+
+	void* const large = pool.allocate(node_pool_resource::maxBlockSize + 1u, 8u);
+	void* const aligned = pool.allocate(32u, 64u);
+	EXPECT_EQ(2u, upstream.allocations());
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(aligned) % 64u);
+
+	pool.deallocate(large, node_pool_resource::maxBlockSize + 1u, 8u);
+	pool.deallocate(aligned, 32u, 64u);
+	EXPECT_EQ(2u, upstream.deallocations());
+}
+
+TEST(NodePoolTest, deallocatesChainsAtOnce)
+{
+	counting_memory_resource upstream{};
+	node_pool_resource pool{ &upstream };
+
+	// linked through their first word, last to first
+	void* blocks[3]{};
+	for (auto& block : blocks) {
+		block = pool.allocate(32u, 8u);
+	}
+	*static_cast<void**>(blocks[2]) = blocks[1];
+	*static_cast<void**>(blocks[1]) = blocks[0];
+	pool.deallocate_chain(blocks[2], blocks[0], 32u, 8u);
+
+	EXPECT_EQ(blocks[2], pool.allocate(32u, 8u));
+	EXPECT_EQ(blocks[1], pool.allocate(32u, 8u));
+	EXPECT_EQ(blocks[0], pool.allocate(32u, 8u));
+	EXPECT_EQ(1u, upstream.allocations());
+
+	void* const large = pool.allocate(1024u, 8u);
+	*static_cast<void**>(large) = pool.allocate(1024u, 8u);
+	pool.deallocate_chain(large, *static_cast<void**>(large), 1024u, 8u);
+	EXPECT_EQ(2u, upstream.deallocations());
+}
+
+TEST(NodePoolTest, allocatesContiguousRuns)
+{
+	counting_memory_resource upstream{};
+	node_pool_resource pool{ &upstream };
+	std::size_t const stride = node_pool_resource::block_size(24u);
+
+	auto* const run = static_cast<std::byte*>(pool.allocate_contiguous(24u, 8u, 100u));
+	EXPECT_EQ(1u, upstream.allocations());
+	EXPECT_EQ(nullptr, pool.allocate_contiguous(node_pool_resource::maxBlockSize + 1u, 8u, 2u));
+
+	// blocks of runs are recycled, single blocks or chains alike
+	for (std::size_t n = 0u; n < 98u; ++n) {
+		pool.deallocate(run + n * stride, 24u, 8u);
+	}
+	void* const last = run + 99u * stride;
+	*reinterpret_cast<void**>(run + 98u * stride) = last;
+	pool.deallocate_chain(run + 98u * stride, last, 24u, 8u);
+	void* const block = pool.allocate(24u, 8u);
+	EXPECT_EQ(run + 98u * stride, block);
+	EXPECT_EQ(0u, upstream.deallocations());
+
+	// the run is kept while one of its blocks is in use, blocks of other sizes do not matter
+	void* const other = pool.allocate_contiguous(48u, 8u, 2u);
+	void* const second = pool.allocate_contiguous(24u, 8u, 2u);
+	EXPECT_EQ(3u, upstream.allocations());
+	EXPECT_EQ(0u, upstream.deallocations());
+
+	// and goes back to upstream with the next run of its size once all of its blocks are deallocated
+	pool.deallocate(block, 24u, 8u);
+	void* const third = pool.allocate_contiguous(24u, 8u, 2u);
+	EXPECT_EQ(1u, upstream.deallocations());
+
+	// its blocks are taken off the free list, so the next block comes from a new chunk
+	void* const fresh = pool.allocate(24u, 8u);
+	EXPECT_EQ(5u, upstream.allocations());
+
+	pool.deallocate(fresh, 24u, 8u);
+	pool.deallocate(other, 48u, 8u);
+	pool.deallocate(static_cast<std::byte*>(other) + node_pool_resource::block_size(48u), 48u, 8u);
+	pool.deallocate(second, 24u, 8u);
+	pool.deallocate(static_cast<std::byte*>(second) + stride, 24u, 8u);
+	pool.deallocate(third, 24u, 8u);
+	pool.deallocate(static_cast<std::byte*>(third) + stride, 24u, 8u);
+}
+
+TEST(NodePoolTest, releaseReturnsEverythingUpstream)
+{
+	counting_memory_resource upstream{};
+	{
+		node_pool_resource pool{ &upstream };
+		std::vector<void*> small{};
+		std::vector<void*> large{};
+		for (int n = 0; n < 1000; ++n) {
+			small.push_back(pool.allocate(16u, 8u));
+			large.push_back(pool.allocate(48u, 8u));
+		}
+		std::size_t const used = upstream.bytes_in_use();
+		EXPECT_LT(0u, used);
+
+		// blocks handed back are kept for reuse, not returned upstream
+		for (void* const p : small) {
+			pool.deallocate(p, 16u, 8u);
+		}
+		EXPECT_EQ(used, upstream.bytes_in_use());
+		for (int n = 0; n < 1000; ++n) {
+			small[static_cast<std::size_t>(n)] = pool.allocate(16u, 8u);
+		}
+		EXPECT_EQ(used, upstream.bytes_in_use());
+
+		// the large blocks are still allocated when the pool goes away
+		for (void* const p : small) {
+			pool.deallocate(p, 16u, 8u);
+		}
+	}
+	EXPECT_EQ(0u, upstream.bytes_in_use());
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace workshop {
+	/**
+	 * @brief PersistentList is an immutable singly linked list whose items are shared between versions,
+	 * so copying it is O(1) and push_front or pop_front on a copy leave the original untouched.
+	 *
+	 * The items are reference counted with atomics, so copies may be handed to other threads and used there
+	 * while the original is still in use. A single PersistentList object is not synchronized though.
+	 * Items no longer used by any version are destroyed in a loop, so long lists do not overflow the stack.
+	 * The memory resource has to be safe to use from every thread releasing items.
+	 */
+	template <typename T>
+	class PersistentList final {
+		struct Item final {
+			std::atomic<std::size_t> references;
+			Item* next;
+			T data;
+
+			template <typename... Args>
+			Item(Item* next, Args&&... args)
+				noexcept(std::is_nothrow_constructible_v<T, Args&&...>)
+				: references{1u}
+				, next{next}
+				, data(std::forward<Args>(args)...)
+			{}
+		};
+
+	public:
+		using value_type = T;
+
+		class const_iterator final {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T const*;
+			using reference = T const&;
+
+			const_iterator() noexcept = default;
+
+			reference operator * () const noexcept {
+				return m_item->data;
+			}
+
+			pointer operator -> () const noexcept {
+				return &m_item->data;
+			}
+
+			const_iterator& operator ++ () noexcept {
+				m_item = m_item->next;
+				return *this;
+			}
+
+			const_iterator operator ++ (int) noexcept {
+				const_iterator const old{ *this };
+				m_item = m_item->next;
+				return old;
+			}
+
+			friend bool operator == (const_iterator const& lhs, const_iterator const& rhs) noexcept {
+				return lhs.m_item == rhs.m_item;
+			}
+
+			friend bool operator != (const_iterator const& lhs, const_iterator const& rhs) noexcept {
+				return lhs.m_item != rhs.m_item;
+			}
+
+		private:
+			friend class PersistentList;
+
+			explicit const_iterator(Item const* const item) noexcept
+				: m_item{item}
+			{}
+
+			Item const* m_item{ nullptr };
+		};
+
+		using iterator = const_iterator;
+
+		PersistentList() noexcept = default;
+
+		explicit PersistentList(std::pmr::memory_resource * resource) noexcept
+			: m_resource{resource}
+		{}
+
+		// delegates, so the destructor releases the items already pushed if copying an element throws
+		PersistentList(std::initializer_list<T> init, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+			: PersistentList(resource)
+		{
+			for (auto n = init.size(); n--;) {
+				push_front(*(init.begin() + n));
+			}
+		}
+
+		// shares all items, O(1)
+		PersistentList(PersistentList const& other) noexcept
+			: m_resource{other.m_resource}
+			, m_head{acquire(other.m_head)}
+			, m_size{other.m_size}
+		{}
+
+		PersistentList& operator = (PersistentList const& other) noexcept {
+			if (this != &other) {
+				Item* const head = acquire(other.m_head);
+				clear();
+				m_resource = other.m_resource;
+				m_head = head;
+				m_size = other.m_size;
+			}
+			return *this;
+		}
+
+		PersistentList(PersistentList&& other) noexcept
+			: m_resource{other.m_resource}
+			, m_head{std::exchange(other.m_head, nullptr)}
+			, m_size{std::exchange(other.m_size, 0u)}
+		{}
+
+		PersistentList& operator = (PersistentList&& other) noexcept {
+			if (this != &other) {
+				clear();
+				m_resource = other.m_resource;
+				m_head = std::exchange(other.m_head, nullptr);
+				m_size = std::exchange(other.m_size, 0u);
+			}
+			return *this;
+		}
+
+		~PersistentList() noexcept {
+			clear();
+		}
+
+		std::pmr::memory_resource * resource() const noexcept {
+			return m_resource;
+		}
+
+		bool empty() const noexcept {
+			return m_size == 0u;
+		}
+
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator{ m_head };
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{};
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		void push_front(T const& value) {
+			emplace_front(value);
+		}
+
+		void push_front(T&& value) {
+			emplace_front(std::move(value));
+		}
+
+		/**
+		 * @brief emplace_front puts a new item in front of the shared ones, the rest of the list is not copied.
+		 * @return The new first element.
+		 */
+		template <typename... Args>
+		T const& emplace_front(Args&&... args) {
+			void* const memory = m_resource->allocate(sizeof(Item), alignof(Item));
+			try {
+				m_head = new(memory) Item(m_head, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				m_resource->deallocate(memory, sizeof(Item), alignof(Item));
+				throw;
+			}
+			++m_size;
+			return m_head->data;
+		}
+
+		/**
+		 * @brief pop_front drops the first element from this version, other versions still see it.
+		 * @throws std::out_of_range if the list is empty.
+		 */
+		void pop_front() {
+			if (!m_head)
+				throw std::out_of_range{ "popping from empty list" };
+
+			Item* const head = std::exchange(m_head, acquire(m_head->next));
+			release(head);
+			--m_size;
+		}
+
+		T const& front() const {
+			if (m_head)
+				return m_head->data;
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		/**
+		 * @brief tail is the list without its first element, sharing all items with this one.
+		 * @throws std::out_of_range if the list is empty.
+		 */
+		PersistentList tail() const {
+			PersistentList rest{ *this };
+			rest.pop_front();
+			return rest;
+		}
+
+		void clear() noexcept {
+			release(std::exchange(m_head, nullptr));
+			m_size = 0u;
+		}
+
+		/**
+		 * @brief shares_items_with tells whether both lists share their first item, which means they share the entire list.
+		 */
+		bool shares_items_with(PersistentList const& other) const noexcept {
+			return m_head && m_head == other.m_head;
+		}
+
+	private:
+		std::pmr::memory_resource * m_resource{ std::pmr::get_default_resource() };
+		Item* m_head{ nullptr };
+		std::size_t m_size{ 0u };
+
+		static Item* acquire(Item* const item) noexcept {
+			if (item)
+				item->references.fetch_add(1u, std::memory_order_relaxed);
+			return item;
+		}
+
+		// drops one reference to item, destroying it and following items no other version uses
+		void release(Item* item) noexcept {
+			while (item && item->references.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+				Item* const next = item->next;
+				item->~Item();
+				m_resource->deallocate(item, sizeof(Item), alignof(Item));
+				item = next;
+			}
+		}
+	};
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "persistent_list.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+#include "../../examples/throwing_copy.hxx"
+
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using workshop::PersistentList;
+
+namespace {
+	template <typename T>
+	std::vector<T> elementsOf(PersistentList<T> const& list) {
+		return { list.begin(), list.end() };
+	}
+}
+
+TEST(PersistentListTest, versions_share_items)
+{
+	counting_memory_resource resource{};
+	{
+		PersistentList<std::string> original{ { "b", "c" }, &resource };
+		EXPECT_EQ(2u, resource.allocations());
+
+		PersistentList<std::string> copy{ original };
+		EXPECT_TRUE(copy.shares_items_with(original));
+		EXPECT_EQ(2u, resource.allocations());
+
+		copy.push_front("a");
+		original.pop_front();
+		EXPECT_EQ(3u, resource.allocations());
+		EXPECT_EQ(0u, resource.deallocations());
+
+		EXPECT_EQ((std::vector<std::string>{ "a", "b", "c" }), elementsOf(copy));
+		EXPECT_EQ(3u, copy.size());
+		EXPECT_EQ((std::vector<std::string>{ "c" }), elementsOf(original));
+		EXPECT_EQ(1u, original.size());
+		EXPECT_TRUE(copy.tail().tail().shares_items_with(original));
+
+		// "a" and "b" are only used by copy
+		copy.clear();
+		EXPECT_EQ(2u, resource.deallocations());
+		EXPECT_EQ("c", original.front());
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(PersistentListTest, assignment_shares_items)
+{
+	PersistentList<int> numbers{ 1, 2, 3 };
+	PersistentList<int> others{ 4 };
+
+	others = numbers;
+	EXPECT_TRUE(others.shares_items_with(numbers));
+	PersistentList<int> const& self = others;
+	others = self;
+	EXPECT_EQ(3u, others.size());
+
+	PersistentList<int> moved{ std::move(others) };
+	EXPECT_TRUE(others.empty());
+	EXPECT_TRUE(moved.shares_items_with(numbers));
+
+	EXPECT_THROW(others.pop_front(), std::out_of_range);
+	EXPECT_THROW(others.front(), std::out_of_range);
+}
+
+TEST(PersistentListTest, releases_items_when_initialization_throws)
+{
+	counting_memory_resource resource{};
+	EXPECT_THROW((PersistentList<throwing_copy>{ { 1, 2, 3 }, &resource }), std::runtime_error);
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(PersistentListTest, releases_long_lists_without_recursion)
+{
+	auto const counter = std::make_shared<int>(0);
+	{
+		PersistentList<std::shared_ptr<int>> pointers{};
+		for (int n = 0; n < 1'000'000; ++n) {
+			pointers.push_front(counter);
+		}
+		PersistentList<std::shared_ptr<int>> const snapshot{ pointers };
+		pointers.clear();
+		EXPECT_EQ(1'000'001, counter.use_count());
+	}
+	EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(PersistentListTest, snapshots_can_be_used_by_other_threads)
+{
+	PersistentList<int> numbers{};
+	std::vector<std::thread> workers{};
+	std::vector<long long> sums(8);
+
+	for (int n = 1; n <= 8; ++n) {
+		for (int k = 0; k < 1000; ++k) {
+			numbers.push_front(k);
+		}
+		workers.emplace_back([snapshot = numbers, &sum = sums[n - 1]]() mutable {
+			// every thread drops the items of its snapshot while the others still share them
+			while (!snapshot.empty()) {
+				sum += snapshot.front();
+				snapshot.pop_front();
+			}
+		});
+	}
+	numbers.clear();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (int n = 1; n <= 8; ++n) {
+		EXPECT_EQ(n * 499'500ll, sums[n - 1]);
+	}
+}
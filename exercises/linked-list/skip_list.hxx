@@ -0,0 +1,424 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace workshop {
+	/**
+	 * @brief SkipList is an ordered set several threads may use at once, built from sorted singly linked lists
+	 * stacked on top of each other, every level skipping about half of the items of the level below.
+	 *
+	 * Lookups and iteration take no locks at all. insert and erase lock only the items they link or unlink,
+	 * after finding them without locks (lazy skip list by Herlihy, Lev, Luchangco and Shavit). Erased items
+	 * are unlinked at once but only freed by reclaim() or the destructor, so a thread still looking at them
+	 * reads valid memory. The memory resource has to be safe to use from several threads.
+	 */
+	template <typename T, typename Compare = std::less<T>>
+	class SkipList final {
+		static constexpr int maxHeight = 24;
+
+		class SpinLock final {
+		public:
+			void lock() noexcept {
+				while (m_flag.test_and_set(std::memory_order_acquire)) {
+					std::this_thread::yield();
+				}
+			}
+
+			void unlock() noexcept {
+				m_flag.clear(std::memory_order_release);
+			}
+
+		private:
+			std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+		};
+
+		// followed by height links, one per level
+		struct Node final {
+			int height;
+			SpinLock lock;
+			// set when erasing, before the node is unlinked
+			std::atomic<bool> marked{ false };
+			// set once the node is linked on all its levels
+			std::atomic<bool> fullyLinked{ false };
+			// erased nodes waiting to be freed
+			Node* retired{ nullptr };
+			// left alone for the head
+			alignas(T) std::byte storage[sizeof(T)];
+
+			explicit Node(int const height) noexcept
+				: height{height}
+			{
+				for (int level = 0; level < height; ++level) {
+					::new(static_cast<void*>(links() + level)) std::atomic<Node*>{ nullptr };
+				}
+			}
+
+			std::atomic<Node*>* links() noexcept {
+				return reinterpret_cast<std::atomic<Node*>*>(this + 1);
+			}
+
+			Node* next(int const level) noexcept {
+				return links()[level].load(std::memory_order_acquire);
+			}
+
+			T& value() noexcept {
+				return *std::launder(reinterpret_cast<T*>(storage));
+			}
+		};
+
+		static_assert(alignof(Node) >= alignof(std::atomic<Node*>));
+
+	public:
+		using value_type = T;
+
+		class const_iterator final {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T const*;
+			using reference = T const&;
+
+			const_iterator() noexcept = default;
+
+			reference operator * () const noexcept {
+				return m_node->value();
+			}
+
+			pointer operator -> () const noexcept {
+				return &m_node->value();
+			}
+
+			const_iterator& operator ++ () noexcept {
+				m_node = live(m_node->next(0));
+				return *this;
+			}
+
+			const_iterator operator ++ (int) noexcept {
+				const_iterator const old{ *this };
+				++*this;
+				return old;
+			}
+
+			friend bool operator == (const_iterator const& lhs, const_iterator const& rhs) noexcept {
+				return lhs.m_node == rhs.m_node;
+			}
+
+			friend bool operator != (const_iterator const& lhs, const_iterator const& rhs) noexcept {
+				return lhs.m_node != rhs.m_node;
+			}
+
+		private:
+			friend class SkipList;
+
+			explicit const_iterator(Node* const node) noexcept
+				: m_node{node}
+			{}
+
+			Node* m_node{ nullptr };
+		};
+
+		using iterator = const_iterator;
+
+		explicit SkipList(std::pmr::memory_resource * resource = std::pmr::get_default_resource(), Compare compare = Compare{})
+			: m_resource{resource}
+			, m_less{std::move(compare)}
+			, m_head{createHead()}
+		{}
+
+		SkipList(SkipList const&) = delete;
+		SkipList& operator = (SkipList const&) = delete;
+
+		~SkipList() noexcept {
+			reclaim();
+			for (Node* node = m_head->next(0); node;) {
+				Node* const next = node->next(0);
+				destroyNode(node);
+				node = next;
+			}
+			deallocateNode(m_head);
+		}
+
+		std::pmr::memory_resource * resource() const noexcept {
+			return m_resource;
+		}
+
+		bool empty() const noexcept {
+			return size() == 0u;
+		}
+
+		std::size_t size() const noexcept {
+			return m_size.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief begin is the smallest element, iterating skips elements being inserted or erased meanwhile.
+		 */
+		const_iterator begin() const noexcept {
+			return const_iterator{ live(m_head->next(0)) };
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{};
+		}
+
+		bool contains(T const& value) const {
+			Node* node = m_head;
+			for (int level = m_levels.load(std::memory_order_acquire); level--;) {
+				Node* next = node->next(level);
+				while (next && m_less(next->value(), value)) {
+					node = next;
+					next = node->next(level);
+				}
+				if (next && !m_less(value, next->value()))
+					return next->fullyLinked.load(std::memory_order_acquire) && !next->marked.load(std::memory_order_acquire);
+			}
+			return false;
+		}
+
+		/**
+		 * @brief insert adds value unless an equal element is already there.
+		 * @return Whether value was added.
+		 */
+		bool insert(T const& value) {
+			return emplace(value);
+		}
+
+		bool insert(T&& value) {
+			return emplace(std::move(value));
+		}
+
+		template <typename... Args>
+		bool emplace(Args&&... args) {
+			Node* const node = createNode(randomHeight(), std::forward<Args>(args)...);
+			int const height = node->height;
+			T const& value = node->value();
+
+			// raised before linking, so nobody searching misses the node on its top level
+			for (int levels = m_levels.load(std::memory_order_relaxed); levels < height;) {
+				if (m_levels.compare_exchange_weak(levels, height, std::memory_order_acq_rel, std::memory_order_relaxed))
+					break;
+			}
+
+			Node* predecessors[maxHeight];
+			Node* successors[maxHeight];
+			for (;;) {
+				if (int const found = find(value, predecessors, successors); found >= 0) {
+					Node* const existing = successors[found];
+					if (!existing->marked.load(std::memory_order_acquire)) {
+						// equal element being inserted by another thread right now
+						while (!existing->fullyLinked.load(std::memory_order_acquire)) {
+							std::this_thread::yield();
+						}
+						destroyNode(node);
+						return false;
+					}
+					// being erased, try again once it is gone
+					std::this_thread::yield();
+					continue;
+				}
+
+				int locked = 0;
+				bool valid = true;
+				for (int level = 0; valid && level < height; ++level) {
+					Node* const predecessor = predecessors[level];
+					Node* const successor = successors[level];
+					if (level == 0 || predecessor != predecessors[level - 1])
+						predecessor->lock.lock();
+					locked = level + 1;
+					valid = !predecessor->marked.load(std::memory_order_acquire)
+						&& (!successor || !successor->marked.load(std::memory_order_acquire))
+						&& predecessor->next(level) == successor;
+				}
+
+				if (valid) {
+					for (int level = 0; level < height; ++level) {
+						node->links()[level].store(successors[level], std::memory_order_relaxed);
+					}
+					for (int level = 0; level < height; ++level) {
+						predecessors[level]->links()[level].store(node, std::memory_order_release);
+					}
+					node->fullyLinked.store(true, std::memory_order_release);
+					m_size.fetch_add(1u, std::memory_order_relaxed);
+				}
+				unlock(predecessors, locked);
+				if (valid)
+					return true;
+			}
+		}
+
+		/**
+		 * @brief erase removes the element equal to value.
+		 * @return Whether there was such an element.
+		 */
+		bool erase(T const& value) {
+			Node* predecessors[maxHeight];
+			Node* successors[maxHeight];
+			Node* victim = nullptr;
+
+			for (;;) {
+				int const found = find(value, predecessors, successors);
+				if (!victim) {
+					if (found < 0)
+						return false;
+
+					// only erase nodes completely linked and found on their top level, otherwise they are still being inserted or erased
+					Node* const candidate = successors[found];
+					if (!candidate->fullyLinked.load(std::memory_order_acquire) || candidate->height - 1 != found
+						|| candidate->marked.load(std::memory_order_acquire))
+						return false;
+
+					candidate->lock.lock();
+					if (candidate->marked.load(std::memory_order_relaxed)) {
+						candidate->lock.unlock();
+						return false;
+					}
+					candidate->marked.store(true, std::memory_order_release);
+					victim = candidate;
+				}
+
+				int locked = 0;
+				bool valid = true;
+				for (int level = 0; valid && level < victim->height; ++level) {
+					Node* const predecessor = predecessors[level];
+					if (level == 0 || predecessor != predecessors[level - 1])
+						predecessor->lock.lock();
+					locked = level + 1;
+					valid = !predecessor->marked.load(std::memory_order_acquire) && predecessor->next(level) == victim;
+				}
+
+				if (valid) {
+					for (int level = victim->height; level--;) {
+						predecessors[level]->links()[level].store(victim->next(level), std::memory_order_release);
+					}
+					victim->lock.unlock();
+					m_size.fetch_sub(1u, std::memory_order_relaxed);
+					retire(victim);
+				}
+				unlock(predecessors, locked);
+				if (valid)
+					return true;
+			}
+		}
+
+		/**
+		 * @brief reclaim frees the erased elements. It must not run while other threads use the list.
+		 */
+		void reclaim() noexcept {
+			for (Node* node = m_retired.exchange(nullptr, std::memory_order_acquire); node;) {
+				Node* const next = node->retired;
+				destroyNode(node);
+				node = next;
+			}
+		}
+
+	private:
+		std::pmr::memory_resource * m_resource;
+		Compare m_less;
+		std::atomic<std::size_t> m_size{ 0u };
+		std::atomic<Node*> m_retired{ nullptr };
+		// the levels any node was linked on so far, searches start below
+		std::atomic<int> m_levels{ 1 };
+		Node* m_head;
+
+		static Node* live(Node* node) noexcept {
+			while (node && (!node->fullyLinked.load(std::memory_order_acquire) || node->marked.load(std::memory_order_acquire))) {
+				node = node->next(0);
+			}
+			return node;
+		}
+
+		static int randomHeight() noexcept {
+			// xorshift, one generator per thread so inserting threads do not contend
+			thread_local std::uint64_t state = (0x9E3779B97F4A7C15u ^ std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+			state ^= state << 13u;
+			state ^= state >> 7u;
+			state ^= state << 17u;
+
+			// every level half as likely as the one below
+			int height = 1;
+			for (std::uint64_t bits = state; (bits & 1u) && height < maxHeight; bits >>= 1u) {
+				++height;
+			}
+			return height;
+		}
+
+		static std::size_t nodeSize(int const height) noexcept {
+			return sizeof(Node) + static_cast<std::size_t>(height) * sizeof(std::atomic<Node*>);
+		}
+
+		// finds the nodes in front of and behind value on every level, returning the highest level value was found on or -1
+		int find(T const& value, Node** const predecessors, Node** const successors) const {
+			int found = -1;
+			Node* node = m_head;
+			int const levels = m_levels.load(std::memory_order_acquire);
+			for (int level = maxHeight; level-- > levels;) {
+				predecessors[level] = m_head;
+				successors[level] = nullptr;
+			}
+			for (int level = levels; level--;) {
+				Node* next = node->next(level);
+				while (next && m_less(next->value(), value)) {
+					node = next;
+					next = node->next(level);
+				}
+				if (found < 0 && next && !m_less(value, next->value()))
+					found = level;
+				predecessors[level] = node;
+				successors[level] = next;
+			}
+			return found;
+		}
+
+		static void unlock(Node* const* const predecessors, int const locked) noexcept {
+			for (int level = 0; level < locked; ++level) {
+				if (level == 0 || predecessors[level] != predecessors[level - 1])
+					predecessors[level]->lock.unlock();
+			}
+		}
+
+		// the head has no value and the full height
+		Node* createHead() {
+			return ::new(m_resource->allocate(nodeSize(maxHeight), alignof(Node))) Node{ maxHeight };
+		}
+
+		template <typename... Args>
+		Node* createNode(int const height, Args&&... args) {
+			auto* const node = ::new(m_resource->allocate(nodeSize(height), alignof(Node))) Node{ height };
+			try {
+				::new(static_cast<void*>(node->storage)) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				deallocateNode(node);
+				throw;
+			}
+			return node;
+		}
+
+		void destroyNode(Node* const node) noexcept {
+			node->value().~T();
+			deallocateNode(node);
+		}
+
+		void deallocateNode(Node* const node) noexcept {
+			int const height = node->height;
+			node->~Node();
+			m_resource->deallocate(node, nodeSize(height), alignof(Node));
+		}
+
+		void retire(Node* const node) noexcept {
+			Node* top = m_retired.load(std::memory_order_relaxed);
+			do {
+				node->retired = top;
+			} while (!m_retired.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+		}
+	};
+}
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include "skip_list.hxx"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+using workshop::SkipList;
+
+namespace {
+	constexpr std::int64_t keys = 1 << 16;
+
+	// the way ordered sets are shared between threads without SkipList
+	class LockedMap final {
+	public:
+		bool contains(std::int64_t const key) const {
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			return m_map.count(key) != 0u;
+		}
+
+		bool insert(std::int64_t const key) {
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			return m_map.emplace(key, true).second;
+		}
+
+		bool erase(std::int64_t const key) {
+			std::lock_guard<std::mutex> const lock{ m_mutex };
+			return m_map.erase(key) != 0u;
+		}
+
+	private:
+		mutable std::mutex m_mutex;
+		std::map<std::int64_t, bool> m_map;
+	};
+
+	struct Set final {
+		bool contains(std::int64_t const key) const {
+			return set.count(key) != 0u;
+		}
+
+		bool insert(std::int64_t const key) {
+			return set.insert(key).second;
+		}
+
+		bool erase(std::int64_t const key) {
+			return set.erase(key) != 0u;
+		}
+
+		std::set<std::int64_t> set;
+	};
+
+	std::uint64_t nextRandom(std::uint64_t& state) noexcept {
+		state ^= state << 13u;
+		state ^= state >> 7u;
+		state ^= state << 17u;
+		return state;
+	}
+
+	// every thread looks up 90% of the time, inserting and erasing the rest, on a set half full
+	template <typename Container>
+	void BM_mixed(benchmark::State& state) {
+		// replaced by the first thread before all threads start, the previous run is over by then
+		static std::unique_ptr<Container> container{};
+		if (state.thread_index() == 0) {
+			container = std::make_unique<Container>();
+			for (std::int64_t key = 0; key < keys; key += 2) {
+				container->insert(key);
+			}
+		}
+
+		std::uint64_t random = 0x9E3779B97F4A7C15u + static_cast<std::uint64_t>(state.thread_index());
+		for (auto _ : state) {
+			std::uint64_t const value = nextRandom(random);
+			auto const key = static_cast<std::int64_t>(value % keys);
+			switch ((value >> 32u) % 20u) {
+			case 0u:
+				benchmark::DoNotOptimize(container->insert(key));
+				break;
+			case 1u:
+				benchmark::DoNotOptimize(container->erase(key));
+				break;
+			default:
+				benchmark::DoNotOptimize(container->contains(key));
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_mixed, Set);
+BENCHMARK_TEMPLATE(BM_mixed, SkipList<std::int64_t>);
+BENCHMARK_TEMPLATE(BM_mixed, LockedMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_mixed, SkipList<std::int64_t>)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using workshop::SkipList;
+
+TEST(SkipListTest, keeps_elements_ordered_and_unique)
+{
+	SkipList<int> numbers{};
+	EXPECT_TRUE(numbers.empty());
+	EXPECT_FALSE(numbers.contains(1));
+
+	for (int n : { 5, 3, 8, 1, 3, 9, 5 }) {
+		numbers.insert(n);
+	}
+	EXPECT_EQ(5u, numbers.size());
+	EXPECT_EQ((std::vector<int>{ 1, 3, 5, 8, 9 }), std::vector<int>(numbers.begin(), numbers.end()));
+	EXPECT_FALSE(numbers.insert(8));
+	EXPECT_TRUE(numbers.contains(8));
+	EXPECT_FALSE(numbers.contains(7));
+
+	EXPECT_TRUE(numbers.erase(8));
+	EXPECT_FALSE(numbers.erase(8));
+	EXPECT_FALSE(numbers.contains(8));
+	EXPECT_EQ((std::vector<int>{ 1, 3, 5, 9 }), std::vector<int>(numbers.begin(), numbers.end()));
+}
+
+TEST(SkipListTest, matches_std_set)
+{
+	std::mt19937 random{ 7u };
+	std::uniform_int_distribution<int> values{ 0, 4999 };
+
+	SkipList<int, std::greater<int>> numbers{};
+	std::set<int, std::greater<int>> expected{};
+	for (int n = 0; n < 50'000; ++n) {
+		int const value = values(random);
+		if (n % 3 == 2)
+			EXPECT_EQ(expected.erase(value) == 1u, numbers.erase(value));
+		else
+			EXPECT_EQ(expected.insert(value).second, numbers.insert(value));
+	}
+
+	EXPECT_EQ(expected.size(), numbers.size());
+	EXPECT_TRUE(std::equal(expected.begin(), expected.end(), numbers.begin(), numbers.end()));
+}
+
+TEST(SkipListTest, frees_erased_elements_on_reclaim)
+{
+	counting_memory_resource resource{};
+	{
+		SkipList<std::string> texts{ &resource };
+		texts.emplace(20u, 'a');
+		texts.insert("b");
+		EXPECT_EQ(3u, resource.allocations());
+
+		EXPECT_TRUE(texts.erase("b"));
+		EXPECT_EQ(0u, resource.deallocations());
+		texts.reclaim();
+		EXPECT_EQ(1u, resource.deallocations());
+
+		// duplicates are not kept
+		texts.insert(std::string(20u, 'a'));
+		EXPECT_EQ(2u, resource.deallocations());
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(SkipListTest, concurrent_inserts_and_erases)
+{
+	constexpr int threads = 8;
+	constexpr int perThread = 5000;
+
+	std::pmr::synchronized_pool_resource pool{};
+	SkipList<int> numbers{ &pool };
+	std::vector<std::thread> workers{};
+
+	// every thread inserts its own range and erases its odd values, while all of them look up everything
+	for (int t = 0; t < threads; ++t) {
+		workers.emplace_back([&numbers, t] {
+			for (int n = t * perThread; n < (t + 1) * perThread; ++n) {
+				numbers.insert(n);
+				EXPECT_TRUE(numbers.contains(n));
+				if (n % 2 == 1) {
+					EXPECT_TRUE(numbers.erase(n));
+				}
+				numbers.contains((n * 31) % (threads * perThread));
+			}
+		});
+	}
+	// and one more competing for some of the even values, which stay
+	workers.emplace_back([&numbers] {
+		for (int n = 0; n < threads * perThread; n += 14) {
+			numbers.insert(n);
+		}
+	});
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	std::vector<int> const values(numbers.begin(), numbers.end());
+	ASSERT_EQ(static_cast<std::size_t>(threads * perThread / 2), values.size());
+	EXPECT_EQ(values.size(), numbers.size());
+	for (std::size_t n = 0u; n < values.size(); ++n) {
+		ASSERT_EQ(static_cast<int>(2u * n), values[n]);
+	}
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace workshop {
+	constexpr std::size_t cacheLineSize = 64u;
+
+	/**
+	 * @brief unrolledCapacity is the number of elements per node filling two cache lines, header included.
+	 */
+	template <typename T>
+	constexpr std::size_t unrolledCapacity() {
+		constexpr std::size_t header = sizeof(void*) + sizeof(std::size_t);
+		return std::max<std::size_t>(1u, (2u * cacheLineSize - header) / sizeof(T));
+	}
+
+	/**
+	 * @brief UnrolledList is a singly linked list storing up to Capacity elements per node,
+	 * so walking it only chases a pointer every Capacity elements.
+	 *
+	 * The elements of a node fill its slots from the back, the first element of the list
+	 * being the first used slot of the first node, so push_front and pop_front stay O(1).
+	 */
+	template <typename T, std::size_t Capacity = unrolledCapacity<T>()>
+	class UnrolledList final {
+		static_assert(Capacity > 0u, "a node has to hold at least one element");
+
+		struct Node final {
+			Node* next;
+			// slots first to Capacity - 1 are in use
+			std::size_t first;
+			alignas(T) std::byte slots[Capacity * sizeof(T)];
+
+			T* at(std::size_t const index) noexcept {
+				return std::launder(reinterpret_cast<T*>(slots + index * sizeof(T)));
+			}
+
+			T const* at(std::size_t const index) const noexcept {
+				return std::launder(reinterpret_cast<T const*>(slots + index * sizeof(T)));
+			}
+		};
+
+		template <bool Const>
+		class Iterator final {
+			using NodePointer = std::conditional_t<Const, Node const*, Node*>;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<Const, T const*, T*>;
+			using reference = std::conditional_t<Const, T const&, T&>;
+
+			Iterator() noexcept = default;
+
+			// iterator converts to const_iterator
+			template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+			Iterator(Iterator<OtherConst> const& other) noexcept
+				: m_node{other.m_node}
+				, m_index{other.m_index}
+			{}
+
+			reference operator * () const noexcept {
+				return *m_node->at(m_index);
+			}
+
+			pointer operator -> () const noexcept {
+				return m_node->at(m_index);
+			}
+
+			Iterator& operator ++ () noexcept {
+				if (++m_index == Capacity) {
+					m_node = m_node->next;
+					m_index = m_node ? m_node->first : 0u;
+				}
+				return *this;
+			}
+
+			Iterator operator ++ (int) noexcept {
+				Iterator const old{ *this };
+				++*this;
+				return old;
+			}
+
+			friend bool operator == (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return lhs.m_node == rhs.m_node && lhs.m_index == rhs.m_index;
+			}
+
+			friend bool operator != (Iterator const& lhs, Iterator const& rhs) noexcept {
+				return !(lhs == rhs);
+			}
+
+		private:
+			friend class UnrolledList;
+			template <bool> friend class Iterator;
+
+			Iterator(NodePointer const node) noexcept
+				: m_node{node}
+				, m_index{node ? node->first : 0u}
+			{}
+
+			NodePointer m_node{ nullptr };
+			std::size_t m_index{ 0u };
+		};
+
+	public:
+		using value_type = T;
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		static constexpr std::size_t capacity = Capacity;
+
+		UnrolledList() noexcept = default;
+
+		explicit UnrolledList(std::pmr::memory_resource * resource) noexcept
+			: m_resource{resource}
+		{}
+
+		// delegates, so the destructor frees the nodes already built if copying an element throws
+		UnrolledList(std::initializer_list<T> init, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+			: UnrolledList(resource)
+		{
+			for (auto n = init.size(); n--;) {
+				push_front(*(init.begin() + n));
+			}
+		}
+
+		UnrolledList(UnrolledList const&) = delete;
+		UnrolledList& operator = (UnrolledList const&) = delete;
+
+		UnrolledList(UnrolledList&& other) noexcept
+			: m_resource{other.m_resource}
+			, m_head{std::exchange(other.m_head, nullptr)}
+			, m_size{std::exchange(other.m_size, 0u)}
+		{}
+
+		UnrolledList& operator = (UnrolledList&& other) noexcept {
+			if (this != &other) {
+				clear();
+				m_resource = other.m_resource;
+				m_head = std::exchange(other.m_head, nullptr);
+				m_size = std::exchange(other.m_size, 0u);
+			}
+			return *this;
+		}
+
+		~UnrolledList() noexcept {
+			clear();
+		}
+
+		std::pmr::memory_resource * resource() const noexcept {
+			return m_resource;
+		}
+
+		bool empty() const noexcept {
+			return m_size == 0u;
+		}
+
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+		void push_front(T const& value) {
+			emplace_front(value);
+		}
+
+		void push_front(T&& value) {
+			emplace_front(std::move(value));
+		}
+
+		template <typename... Args>
+		T& emplace_front(Args&&... args) {
+			bool const needsNode = !m_head || m_head->first == 0u;
+			Node* const node = needsNode ? createNode() : m_head;
+
+			try {
+				::new(static_cast<void*>(node->at(node->first - 1u))) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				if (needsNode)
+					m_resource->deallocate(node, sizeof(Node), alignof(Node));
+				throw;
+			}
+
+			--node->first;
+			if (needsNode) {
+				node->next = m_head;
+				m_head = node;
+			}
+			++m_size;
+			return *node->at(node->first);
+		}
+
+		/**
+		 * @brief pop_front removes the first element.
+		 * @return The removed element, moved out of the list.
+		 * @throws std::out_of_range if the list is empty.
+		 */
+		T pop_front() {
+			if (!m_head)
+				throw std::out_of_range{ "popping from empty list" };
+
+			T* const element = m_head->at(m_head->first);
+			T value{ std::move(*element) };
+			element->~T();
+			if (++m_head->first == Capacity)
+				destroyNode(std::exchange(m_head, m_head->next));
+			--m_size;
+			return value;
+		}
+
+		T& front() {
+			if (m_head)
+				return *m_head->at(m_head->first);
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		T const& front() const {
+			if (m_head)
+				return *m_head->at(m_head->first);
+			throw std::out_of_range{ "accessing front of empty list" };
+		}
+
+		void clear() noexcept {
+			while (m_head) {
+				if constexpr (!std::is_trivially_destructible_v<T>) {
+					for (std::size_t n = m_head->first; n < Capacity; ++n) {
+						m_head->at(n)->~T();
+					}
+				}
+				destroyNode(std::exchange(m_head, m_head->next));
+			}
+			m_size = 0u;
+		}
+
+		iterator begin() noexcept {
+			return iterator{ m_head };
+		}
+
+		iterator end() noexcept {
+			return iterator{};
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator{ m_head };
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator{};
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		/**
+		 * @brief for_each calls f for every element in order, walking the elements
+		 * of each node as one contiguous array, which is as fast as iterating a vector.
+		 */
+		template <typename F>
+		void for_each(F f) {
+			for (Node* node = m_head; node; node = node->next) {
+				// a node always holds at least one element, slots before first hold none
+				T* const elements = node->at(node->first);
+				for (std::size_t n = 0u; n < Capacity - node->first; ++n) {
+					f(elements[n]);
+				}
+			}
+		}
+
+		template <typename F>
+		void for_each(F f) const {
+			for (Node const* node = m_head; node; node = node->next) {
+				// a node always holds at least one element, slots before first hold none
+				T const* const elements = node->at(node->first);
+				for (std::size_t n = 0u; n < Capacity - node->first; ++n) {
+					f(elements[n]);
+				}
+			}
+		}
+
+	private:
+		std::pmr::memory_resource * m_resource{ std::pmr::get_default_resource() };
+		Node* m_head{ nullptr };
+		std::size_t m_size{ 0u };
+
+		Node* createNode() {
+			// default initialized, leaving the slots alone
+			auto* const node = ::new(m_resource->allocate(sizeof(Node), alignof(Node))) Node;
+			node->next = nullptr;
+			node->first = Capacity;
+			return node;
+		}
+
+		void destroyNode(Node* const node) noexcept {
+			m_resource->deallocate(node, sizeof(Node), alignof(Node));
+		}
+	};
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include "unrolled_list.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+#include "../../examples/throwing_copy.hxx"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using workshop::UnrolledList;
+
+TEST(UnrolledListTest, capacity_fills_two_cache_lines)
+{
+	EXPECT_EQ(28u, (UnrolledList<std::int32_t>::capacity));
+	EXPECT_EQ(14u, (UnrolledList<std::int64_t>::capacity));
+	EXPECT_EQ(1u, (UnrolledList<std::array<char, 500>>::capacity));
+}
+
+TEST(UnrolledListTest, push_and_pop_front)
+{
+	UnrolledList<int, 4> numbers{};
+	EXPECT_TRUE(numbers.empty());
+
+	for (int n = 0; n < 10; ++n) {
+		numbers.push_front(n);
+		EXPECT_EQ(n, numbers.front());
+	}
+	EXPECT_EQ(10u, numbers.size());
+
+	for (int n = 10; n--;) {
+		EXPECT_EQ(n, numbers.pop_front());
+	}
+	EXPECT_TRUE(numbers.empty());
+	EXPECT_THROW(numbers.pop_front(), std::out_of_range);
+	EXPECT_THROW(numbers.front(), std::out_of_range);
+}
+
+TEST(UnrolledListTest, allocates_one_node_per_capacity_elements)
+{
+	counting_memory_resource resource{};
+	{
+		UnrolledList<int, 4> numbers{ &resource };
+		for (int n = 0; n < 9; ++n) {
+			numbers.push_front(n);
+		}
+		EXPECT_EQ(3u, resource.allocations());
+
+		numbers.pop_front();
+		EXPECT_EQ(1u, resource.deallocations());
+	}
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(UnrolledListTest, frees_nodes_when_initialization_throws)
+{
+	counting_memory_resource resource{};
+	EXPECT_THROW((UnrolledList<throwing_copy, 2>{ { 1, 2, 3, 4, 5 }, &resource }), std::runtime_error);
+	EXPECT_EQ(0u, resource.bytes_in_use());
+}
+
+TEST(UnrolledListTest, iterates_in_order)
+{
+	UnrolledList<int, 3> const numbers{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	std::vector<int> const expected{ 1, 2, 3, 4, 5, 6, 7, 8 };
+	EXPECT_EQ(expected, std::vector<int>(numbers.begin(), numbers.end()));
+
+	std::vector<int> visited{};
+	numbers.for_each([&visited](int const n) { visited.push_back(n); });
+	EXPECT_EQ(expected, visited);
+
+	EXPECT_EQ(36, std::accumulate(numbers.begin(), numbers.end(), 0));
+}
+
+TEST(UnrolledListTest, iterators_allow_modification)
+{
+	UnrolledList<int, 2> numbers{ 1, 2, 3 };
+	for (int& n : numbers) {
+		n *= 10;
+	}
+	UnrolledList<int, 2>::const_iterator const it = numbers.begin();
+	EXPECT_EQ(10, *it);
+	EXPECT_EQ(3, std::count_if(numbers.cbegin(), numbers.cend(), [](int n) { return n % 10 == 0; }));
+}
+
+TEST(UnrolledListTest, destroys_remaining_elements)
+{
+	auto const counter = std::make_shared<int>(0);
+	{
+		UnrolledList<std::shared_ptr<int>, 4> pointers{};
+		for (int n = 0; n < 6; ++n) {
+			pointers.push_front(counter);
+		}
+		EXPECT_EQ(7, counter.use_count());
+		pointers.pop_front();
+		EXPECT_EQ(6, counter.use_count());
+	}
+	EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(UnrolledListTest, supports_move_only_elements)
+{
+	UnrolledList<std::unique_ptr<std::string>> texts{};
+	texts.emplace_front(std::make_unique<std::string>("alpha"));
+	texts.push_front(std::make_unique<std::string>("bravo"));
+
+	EXPECT_EQ("bravo", *texts.pop_front());
+	EXPECT_EQ("alpha", *texts.front());
+
+	UnrolledList<std::unique_ptr<std::string>> moved{ std::move(texts) };
+	EXPECT_EQ(1u, moved.size());
+	EXPECT_TRUE(texts.empty());
+}
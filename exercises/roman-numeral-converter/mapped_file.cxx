@@ -0,0 +1,101 @@
+#include "mapped_file.hxx"
+
+#include <system_error>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace workshop {
+	namespace {
+#if defined(_WIN32)
+		[[noreturn]] void fail(char const* const what) {
+			throw std::system_error{ static_cast<int>(GetLastError()), std::system_category(), what };
+		}
+#elif defined(__unix__) || defined(__APPLE__)
+		[[noreturn]] void fail(char const* const what) {
+			throw std::system_error{ errno, std::generic_category(), what };
+		}
+#endif
+	}
+
+	mapped_file::mapped_file(char const* const path) {
+#if defined(_WIN32)
+		HANDLE const file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			fail("opening file");
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			fail("getting file size");
+		}
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		// mapping an empty file fails, there is nothing to map anyway
+		if (m_size == 0u) {
+			CloseHandle(file);
+			return;
+		}
+
+		// the view keeps the file open, the handles are not needed anymore
+		HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			fail("mapping file");
+		m_data = static_cast<char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		CloseHandle(mapping);
+		if (!m_data)
+			fail("mapping file");
+#elif defined(__unix__) || defined(__APPLE__)
+		int const file = open(path, O_RDONLY);
+		if (file < 0)
+			fail("opening file");
+
+		struct stat status{};
+		if (fstat(file, &status) != 0) {
+			int const error = errno;
+			close(file);
+			errno = error;
+			fail("getting file size");
+		}
+		m_size = static_cast<std::size_t>(status.st_size);
+		// mapping an empty file fails, there is nothing to map anyway
+		if (m_size == 0u) {
+			close(file);
+			return;
+		}
+
+		// the mapping keeps the file open, the descriptor is not needed anymore
+		void* const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		int const error = errno;
+		close(file);
+		if (data == MAP_FAILED) {
+			errno = error;
+			fail("mapping file");
+		}
+		// only a hint, the mapping is fine without it
+		madvise(data, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<char const*>(data);
+#else
+		static_cast<void>(path);
+		throw std::system_error{ std::make_error_code(std::errc::function_not_supported), "mapping file" };
+#endif
+	}
+
+	mapped_file::~mapped_file() noexcept {
+		if (!m_data)
+			return;
+#if defined(_WIN32)
+		UnmapViewOfFile(m_data);
+#elif defined(__unix__) || defined(__APPLE__)
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+	}
+}
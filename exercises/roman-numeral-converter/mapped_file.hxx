@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace workshop {
+	/**
+	 * @brief mapped_file maps a whole file read only into memory, so it can be read without copying it into buffers.
+	 *
+	 * The operating system is told that the file is read sequentially, so it reads ahead generously.
+	 */
+	class mapped_file final {
+	public:
+		/**
+		 * @throws std::system_error if the file cannot be opened or mapped.
+		 */
+		explicit mapped_file(char const* path);
+
+		mapped_file(mapped_file const&) = delete;
+		mapped_file& operator = (mapped_file const&) = delete;
+
+		~mapped_file() noexcept;
+
+		std::string_view view() const noexcept {
+			return { m_data, m_size };
+		}
+
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+	private:
+		char const* m_data{ nullptr };
+		std::size_t m_size{ 0u };
+	};
+}
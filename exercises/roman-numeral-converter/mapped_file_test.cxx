@@ -0,0 +1,63 @@
+#include "mapped_file.hxx"
+namespace w = workshop;
+
+#include <gtest/gtest.h>
+namespace t = testing;
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+namespace s = std;
+
+namespace {
+	// a file removed again at the end of the test
+	class TemporaryFile final {
+	public:
+		TemporaryFile(char const* const name, s::string const& content)
+			: m_path{ s::filesystem::temp_directory_path() / name }
+		{
+			s::ofstream{ m_path, s::ios::binary } << content;
+		}
+
+		~TemporaryFile() {
+			s::error_code ignored{};
+			s::filesystem::remove(m_path, ignored);
+		}
+
+		s::string path() const {
+			return m_path.string();
+		}
+
+	private:
+		s::filesystem::path m_path;
+	};
+}
+
+TEST(MappedFileTest, maps_the_whole_file)
+{
+	s::string content{};
+	for (int n = 0; n < 100000; ++n) {
+		content += "MCMXC\r\n";
+	}
+	TemporaryFile const file{ "mapped_file_test_content.txt", content };
+
+	w::mapped_file const mapped{ file.path().c_str() };
+	ASSERT_EQ(content.size(), mapped.size());
+	ASSERT_EQ(content, mapped.view());
+}
+
+TEST(MappedFileTest, maps_empty_files)
+{
+	TemporaryFile const file{ "mapped_file_test_empty.txt", "" };
+
+	w::mapped_file const mapped{ file.path().c_str() };
+	ASSERT_EQ(0u, mapped.size());
+	ASSERT_TRUE(mapped.view().empty());
+}
+
+TEST(MappedFileTest, throws_for_missing_files)
+{
+	auto const path = (s::filesystem::temp_directory_path() / "mapped_file_test_missing.txt").string();
+	ASSERT_THROW(w::mapped_file{ path.c_str() }, s::system_error);
+}
@@ -1,28 +1,27 @@
 #include "roman_numeral_converter.hxx"
 
 #include <cassert>
+#include <algorithm>
 #include <array>
-#include <memory_resource>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
 #include <tuple>
-#include <unordered_map>
+#include <vector>
 
-#include "../../examples/debugging_memory_resource.hxx"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROMAN_SSE2
+#include <emmintrin.h>
+#endif
 
-std::array<std::byte, 1000000000L> static_mem;
-std::pmr::monotonic_buffer_resource static_resource{
-	static_mem.data(),
-	static_mem.size(),
-	std::pmr::null_memory_resource()
-};
-
-/*
-int main() {
-	std::pmr::set_default_resource(&static_resource);
-}
-*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace {
 	using namespace std;
+	using namespace workshop::detail;
 
 	array<tuple<string_view, int>, 13> const mapping{
 		tuple { "M", 1000 },
@@ -40,15 +39,44 @@ namespace {
 		tuple { "I", 1 },
 	};
 
-	string operator * (string_view part, int count) {
-		assert(count >= 0 && count <= 3);
-		string result{};
-		while (count--) {
-			result += part;
+	constexpr size_t totalLength() {
+		size_t length{ 0u };
+		for (int value = 1; value <= 3999; ++value) {
+			for (string_view const part : digitsOf(value)) {
+				length += part.size();
+			}
 		}
-		return result;
+		return length;
+	}
+
+	// all numerals back to back, the numeral of value being chars[offsets[value]] to chars[offsets[value + 1]]
+	struct RomanTable final {
+		array<char, totalLength()> chars;
+		array<uint16_t, 4001> offsets;
+	};
+
+	constexpr RomanTable makeTable() {
+		RomanTable table{};
+		size_t position{ 0u };
+		for (int value = 1; value <= 3999; ++value) {
+			table.offsets[value] = static_cast<uint16_t>(position);
+			for (string_view const part : digitsOf(value)) {
+				for (char const c : part) {
+					table.chars[position++] = c;
+				}
+			}
+		}
+		table.offsets[4000] = static_cast<uint16_t>(position);
+		return table;
 	}
 
+	static_assert(totalLength() <= numeric_limits<uint16_t>::max());
+	constexpr RomanTable table = makeTable();
+
+	// all static data of the converter, constant initialized, so nothing is built or allocated at startup
+	static_assert(sizeof(RomanTable) + sizeof(automaton) + sizeof(letters) + sizeof(digits) <= 48u * 1024u,
+		"the converter's tables should stay small");
+
 	int prefixCount(string_view roman, string_view prefix) {
 		if (prefix.size() == 1) {
 			int count{ 0 };
@@ -88,77 +116,246 @@ namespace {
 		return result;
 	}
 
-	int from_roman_with_reverse_mapping(std::string_view value) {
-		// this is only an estimate
-		constexpr std::size_t const BUFFER_SIZE
-			= 3999
-			* sizeof(std::pmr::unordered_map<std::string, int>::node_type)
-			* 6;
-		static_assert(sizeof(std::pmr::unordered_map<std::string, int>::node_type) == 16);
+	constexpr string_view numeralOf(int const value) {
+		return { table.chars.data() + table.offsets[value], static_cast<size_t>(table.offsets[value + 1] - table.offsets[value]) };
+	}
 
-		static std::array<std::byte, BUFFER_SIZE> buffer;
-		// static debugging_memory_resource base_resource{};
-		static std::pmr::monotonic_buffer_resource resource{ buffer.data(), buffer.size() , std::pmr::null_memory_resource() };
+#if defined(ROMAN_SSE2)
+	unsigned countTrailingZeros(unsigned const bits) noexcept {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+	}
+#endif
 
-		// IIFE - Immediatly Invoked Function Expression
-		static std::pmr::unordered_map<std::string, int> const reverse_mapping = [](std::pmr::memory_resource * resource) {
-			std::pmr::unordered_map<std::string, int> rmap{ resource };
-			for (int n = 1; n <= 3999; ++n) {
-				rmap.emplace(workshop::to_roman(n), n);
-			}
-			return rmap;
-		}(&resource);
+	size_t countOnes(uint64_t bits) noexcept {
+		size_t count{ 0u };
+		for (; bits != 0u; bits &= bits - 1u) {
+			++count;
+		}
+		return count;
+	}
 
-		auto const it = reverse_mapping.find(std::string{ value });
-		if (it == reverse_mapping.end()) {
-			throw std::invalid_argument{ "value is not a valid Roman numeral" };
+	bool inRange(int const value) noexcept {
+		return value >= 1 && value <= 3999;
+	}
+
+	// finds the next newline, comparing 16 characters at a time
+	char const* findNewline(char const* first, char const* const last) noexcept {
+#if defined(ROMAN_SSE2)
+		__m128i const newline = _mm_set1_epi8('\n');
+		for (; last - first >= 16; first += 16) {
+			__m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+			if (int const mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)))
+				return first + countTrailingZeros(static_cast<unsigned>(mask));
 		}
+#endif
+		return std::find(first, last, '\n');
+	}
 
-		return it->second;
+	size_t countNewlines(char const* first, char const* const last) noexcept {
+		size_t count{ 0u };
+#if defined(ROMAN_SSE2)
+		__m128i const newline = _mm_set1_epi8('\n');
+		for (; last - first >= 16; first += 16) {
+			__m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+			count += countOnes(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline))));
+		}
+#endif
+		return count + static_cast<size_t>(std::count(first, last, '\n'));
+	}
+
+	// runs f(index) for every worker, the first one on the calling thread
+	template <typename F>
+	void inParallel(int const workers, F const& f) {
+		vector<thread> threads{};
+		threads.reserve(static_cast<size_t>(workers > 1 ? workers - 1 : 0));
+		for (int index = 1; index < workers; ++index) {
+			threads.emplace_back([&f, index] { f(index); });
+		}
+		f(0);
+		for (auto& t : threads) {
+			t.join();
+		}
+	}
+
+	// splits count elements among the workers in multiples of 64, so no two share a word of the error bitmap
+	array<size_t, 2> rangeOf(size_t const count, int const workers, int const index) noexcept {
+		size_t const words = (count + 63u) / 64u;
+		size_t const begin = words * static_cast<size_t>(index) / static_cast<size_t>(workers) * 64u;
+		size_t const end = words * static_cast<size_t>(index + 1) / static_cast<size_t>(workers) * 64u;
+		return { min(begin, count), min(end, count) };
+	}
+
+	// writes the bits of elements [begin, end) to errors, whole words at a time
+	template <typename IsError>
+	size_t markErrors(size_t const begin, size_t const end, uint64_t* const errors, IsError const& isError) noexcept {
+		size_t invalid{ 0u };
+		for (size_t word = begin / 64u; word * 64u < end; ++word) {
+			uint64_t bits{ 0u };
+			size_t const last = min(end, word * 64u + 64u);
+			for (size_t n = word * 64u; n < last; ++n) {
+				if (isError(n))
+					bits |= uint64_t{ 1 } << (n % 64u);
+			}
+			errors[word] = bits;
+			invalid += countOnes(bits);
+		}
+		return invalid;
+	}
+
+	// small batches are not worth starting threads
+	int workersFor(size_t const count, int const workers) noexcept {
+		constexpr size_t minimumPerWorker = 1u << 14u;
+		return static_cast<int>(max<size_t>(1u, min<size_t>(static_cast<size_t>(max(workers, 1)), count / minimumPerWorker)));
 	}
 }
 
-std::string operator * (std::string_view part, int count) {
-	assert(count >= 0 && count <= 3);
-	std::string result{};
-	while (count--) {
-		result += part;
+std::optional<std::string_view> workshop::try_to_roman(int const value) noexcept
+{
+	if (!inRange(value)) {
+		return std::nullopt;
 	}
-	return result;
+
+	return numeralOf(value);
 }
 
-std::string workshop::to_roman(int value)
+std::string_view workshop::to_roman_view(int const value)
 {
-	using ::operator*;
+	if (auto const numeral = try_to_roman(value)) {
+		return *numeral;
+	}
+	throw std::invalid_argument{ "value is not in the range of 1 to 3999" };
+}
 
-	if (value < 1 || value > 3999) {
-		throw std::invalid_argument{ "value is not in the range of 1 to 3999" };
+std::to_chars_result workshop::to_roman(char* const first, char* const last, int const value) noexcept
+{
+	if (!inRange(value)) {
+		return { last, std::errc::invalid_argument };
+	}
+
+	std::size_t const begin = table.offsets[value];
+	std::size_t const length = table.offsets[value + 1] - begin;
+	if (static_cast<std::size_t>(last - first) < length) {
+		return { last, std::errc::value_too_large };
 	}
+	return { std::copy_n(table.chars.data() + begin, length, first), std::errc{} };
+}
+
+void workshop::append_roman(std::string& out, int const value)
+{
+	out += to_roman_view(value);
+}
+
+std::pmr::string workshop::to_roman(int const value, std::pmr::memory_resource * const resource)
+{
+	return std::pmr::string{ to_roman_view(value), resource };
+}
 
+std::string workshop::to_roman(int const value)
+{
+	// never exceeds the small string buffer of common implementations
 	std::string result{};
-	for (auto const[roman, arabic] : mapping) {
-		int const count = value / arabic;
-		value %= arabic;
-		result += roman * count;
+	append_roman(result, value);
+	return result;
+}
+
+std::optional<int> workshop::try_from_roman(std::string_view const value) noexcept
+{
+	if (int const result = from_roman_with_automaton(value)) {
+		return result;
+	}
+	return std::nullopt;
+}
+
+int workshop::from_roman(std::string_view const value)
+{
+	if (auto const result = try_from_roman(value)) {
+		return *result;
+	}
+	throw std::invalid_argument{ "value is not a valid Roman numeral" };
+}
 
-		// without the custom operator*
-		/*
-		while (value >= arabic) {
-			value -= arabic;
-			result += roman;
+std::size_t workshop::to_roman_batch(int const* const values, std::size_t const count, std::string_view* const numerals, std::uint64_t* const errors, int const workers)
+{
+	std::atomic<std::size_t> invalid{ 0u };
+	int const used = workersFor(count, workers);
+	inParallel(used, [&](int const index) {
+		auto const [begin, end] = rangeOf(count, used, index);
+		for (std::size_t n = begin; n < end; ++n) {
+			numerals[n] = inRange(values[n]) ? numeralOf(values[n]) : std::string_view{};
 		}
-		*/
+		invalid += markErrors(begin, end, errors, [values](std::size_t const n) { return !inRange(values[n]); });
+	});
+	return invalid;
+}
 
-		// optimization as it makes no sense to check the remaining mappings
-		if (value == 0) {
-			break;
+std::size_t workshop::from_roman_batch(std::string_view const* const numerals, std::size_t const count, int* const values, std::uint64_t* const errors, int const workers)
+{
+	std::atomic<std::size_t> invalid{ 0u };
+	int const used = workersFor(count, workers);
+	inParallel(used, [&](int const index) {
+		auto const [begin, end] = rangeOf(count, used, index);
+		for (std::size_t n = begin; n < end; ++n) {
+			values[n] = from_roman_with_automaton(numerals[n]);
 		}
-	}
+		invalid += markErrors(begin, end, errors, [values](std::size_t const n) { return values[n] == 0; });
+	});
+	return invalid;
+}
 
-	return result;
+std::size_t workshop::count_lines(std::string_view const text) noexcept
+{
+	std::size_t const newlines = countNewlines(text.data(), text.data() + text.size());
+	return newlines + (!text.empty() && text.back() != '\n' ? 1u : 0u);
 }
 
-int workshop::from_roman(std::string_view const value)
+std::size_t workshop::from_roman_lines(std::string_view const text, int* const values, std::uint64_t* const errors, int const workers)
 {
-	return from_roman_with_reverse_mapping(value);
+	char const* const first = text.data();
+	char const* const last = first + text.size();
+
+	// chunks of about the same size, ending behind a newline
+	int const used = workersFor(text.size() / 8u, workers);
+	std::vector<char const*> bounds(static_cast<std::size_t>(used) + 1u, last);
+	bounds[0] = first;
+	for (int index = 1; index < used; ++index) {
+		char const* const middle = std::max(bounds[index - 1], first + text.size() * static_cast<std::size_t>(index) / static_cast<std::size_t>(used));
+		char const* const newline = findNewline(middle, last);
+		bounds[index] = newline == last ? last : newline + 1;
+	}
+
+	// the index of the first line of every chunk
+	std::vector<std::size_t> lines(static_cast<std::size_t>(used) + 1u, 0u);
+	inParallel(used, [&](int const index) {
+		lines[index + 1] = count_lines({ bounds[index], static_cast<std::size_t>(bounds[index + 1] - bounds[index]) });
+	});
+	for (int index = 0; index < used; ++index) {
+		lines[index + 1] += lines[index];
+	}
+	std::size_t const parsed = lines[used];
+
+	inParallel(used, [&](int const index) {
+		std::size_t line = lines[index];
+		for (char const* begin = bounds[index]; begin != bounds[index + 1]; ++line) {
+			char const* const newline = findNewline(begin, bounds[index + 1]);
+			std::string_view numeral{ begin, static_cast<std::size_t>(newline - begin) };
+			if (!numeral.empty() && numeral.back() == '\r')
+				numeral.remove_suffix(1u);
+			values[line] = from_roman_with_automaton(numeral);
+			begin = newline == bounds[index + 1] ? newline : newline + 1;
+		}
+	});
+
+	std::atomic<std::size_t> invalid{ 0u };
+	int const marking = workersFor(parsed, workers);
+	inParallel(marking, [&](int const index) {
+		auto const [begin, end] = rangeOf(parsed, marking, index);
+		invalid += markErrors(begin, end, errors, [values](std::size_t const n) { return values[n] == 0; });
+	});
+	return invalid;
 }
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 
+#include "roman_numeral_core.hxx"
+
 namespace workshop {
 	/**
 	 * @brief to_roman converts the given value to its Roman numeral representation.
@@ -13,6 +21,55 @@ namespace workshop {
 	 */
 	std::string to_roman(int value);
 
+	/**
+	 * @brief to_roman converts the given value to its Roman numeral representation,
+	 * allocating the string from the given resource if it does not fit into the string itself.
+	 * @param value An integer in the range of 1 to 3999.
+	 * @return A string containing the Roman numeral.
+	 * @throws std::invalid_argument if the value is not in the expected range.
+	 */
+	std::pmr::string to_roman(int value, std::pmr::memory_resource * resource);
+
+	/**
+	 * @brief to_roman_view looks up the Roman numeral representation of the given value
+	 * in a table of all numerals built at compile time.
+	 * @param value An integer in the range of 1 to 3999.
+	 * @return A view of the Roman numeral, valid for the lifetime of the program.
+	 * @throws std::invalid_argument if the value is not in the expected range.
+	 */
+	std::string_view to_roman_view(int value);
+
+	/**
+	 * @brief try_to_roman looks up the Roman numeral representation of the given value like to_roman_view,
+	 * but reports values out of range without throwing.
+	 * @param value An integer, converted if in the range of 1 to 3999.
+	 * @return A view of the Roman numeral, valid for the lifetime of the program, or nothing if the value is not in the expected range.
+	 */
+	std::optional<std::string_view> try_to_roman(int value) noexcept;
+
+	/**
+	 * @brief max_roman_length is the length of the longest Roman numeral, MMMDCCCLXXXVIII (3888).
+	 */
+	constexpr std::size_t max_roman_length = 15u;
+
+	/**
+	 * @brief to_roman writes the Roman numeral representation of the given value to [first, last)
+	 * without allocating, like std::to_chars.
+	 * @param value An integer in the range of 1 to 3999.
+	 * @return The end of the written characters and std::errc{} on success. On failure ptr is last
+	 * and ec is std::errc::invalid_argument if the value is not in the expected range or
+	 * std::errc::value_too_large if the buffer is too small.
+	 */
+	std::to_chars_result to_roman(char* first, char* last, int value) noexcept;
+
+	/**
+	 * @brief append_roman appends the Roman numeral representation of the given value to out,
+	 * only allocating if out lacks the capacity.
+	 * @param value An integer in the range of 1 to 3999.
+	 * @throws std::invalid_argument if the value is not in the expected range.
+	 */
+	void append_roman(std::string& out, int value);
+
 	/**
 	 * @brief from_roman parses a Roman numeral to get its integer value.
 	 * @param value The Roman numeral (letters must be all uppercase).
@@ -20,4 +77,107 @@ namespace workshop {
 	 * @throws std::invalid_argument if the input is not a valid Roman numeral.
 	 */
 	int from_roman(std::string_view value);
+
+	/**
+	 * @brief try_from_roman parses a Roman numeral like from_roman, but reports invalid input without throwing.
+	 * @param value The Roman numeral (letters must be all uppercase).
+	 * @return An integer in the range of 1 to 3999, or nothing if the input is not a valid Roman numeral.
+	 */
+	std::optional<int> try_from_roman(std::string_view value) noexcept;
+
+	/**
+	 * @brief to_roman_batch converts count values at once, reporting invalid values in a bitmap instead of throwing.
+	 * @param values The values to convert, each should be in the range of 1 to 3999.
+	 * @param numerals Receives count views into the table of all numerals, empty for invalid values.
+	 * @param errors Receives (count + 63) / 64 words, bit n % 64 of word n / 64 is set if value n is invalid.
+	 * @param workers The number of threads to use at most, batches too small to profit from threads use fewer.
+	 * @return The number of invalid values.
+	 */
+	std::size_t to_roman_batch(int const* values, std::size_t count, std::string_view* numerals, std::uint64_t* errors, int workers = 1);
+
+	/**
+	 * @brief from_roman_batch parses count Roman numerals at once, reporting invalid numerals in a bitmap instead of throwing.
+	 * @param numerals The numerals to parse (letters must be all uppercase).
+	 * @param values Receives count integers in the range of 1 to 3999, 0 for invalid numerals.
+	 * @param errors Receives (count + 63) / 64 words, bit n % 64 of word n / 64 is set if numeral n is invalid.
+	 * @param workers The number of threads to use at most, batches too small to profit from threads use fewer.
+	 * @return The number of invalid numerals.
+	 */
+	std::size_t from_roman_batch(std::string_view const* numerals, std::size_t count, int* values, std::uint64_t* errors, int workers = 1);
+
+	/**
+	 * @brief count_lines counts the lines of text, a last line without a newline included.
+	 */
+	std::size_t count_lines(std::string_view text) noexcept;
+
+	/**
+	 * @brief from_roman_lines parses a column of Roman numerals, one per line, without splitting it into views first.
+	 * Lines may end in "\n" or "\r\n".
+	 * @param values Receives count_lines(text) integers in the range of 1 to 3999, 0 for invalid numerals.
+	 * @param errors Receives (count_lines(text) + 63) / 64 words, bit n % 64 of word n / 64 is set if line n is invalid.
+	 * @param workers The number of threads to use at most, texts too small to profit from threads use fewer.
+	 * @return The number of invalid lines.
+	 */
+	std::size_t from_roman_lines(std::string_view text, int* values, std::uint64_t* errors, int workers = 1);
+
+	/**
+	 * @brief roman_numeral holds a Roman numeral without allocating, so it can be built at compile time.
+	 */
+	struct roman_numeral final {
+		std::array<char, max_roman_length> chars{};
+		std::size_t length{ 0u };
+
+		constexpr std::string_view view() const noexcept {
+			return { chars.data(), length };
+		}
+
+		constexpr operator std::string_view () const noexcept {
+			return view();
+		}
+	};
+
+	/**
+	 * @brief make_roman is the constexpr counterpart of to_roman.
+	 * @param value An integer in the range of 1 to 3999.
+	 * @return The Roman numeral.
+	 * @throws std::invalid_argument if the value is not in the expected range, which fails to compile in constant expressions.
+	 */
+	constexpr roman_numeral make_roman(int const value) {
+		if (value < 1 || value > 3999) {
+			throw std::invalid_argument{ "value is not in the range of 1 to 3999" };
+		}
+
+		roman_numeral numeral{};
+		for (std::string_view const part : detail::digitsOf(value)) {
+			for (char const c : part) {
+				numeral.chars[numeral.length++] = c;
+			}
+		}
+		return numeral;
+	}
+
+	/**
+	 * @brief parse_roman is the constexpr counterpart of from_roman, walking the same automaton.
+	 * @param value The Roman numeral (letters must be all uppercase).
+	 * @return An integer in the range of 1 to 3999.
+	 * @throws std::invalid_argument if the input is not a valid Roman numeral, which fails to compile in constant expressions.
+	 */
+	constexpr int parse_roman(std::string_view const value) {
+		if (int const result = detail::from_roman_with_automaton(value)) {
+			return result;
+		}
+		throw std::invalid_argument{ "value is not a valid Roman numeral" };
+	}
+
+	inline namespace literals {
+		/**
+		 * @brief _roman parses a Roman numeral literal, "MCMXCIV"_roman is 1994.
+		 *
+		 * C++17 cannot force evaluation at compile time, so use the literal in a constant expression,
+		 * like the initializer of a constexpr variable, to have invalid numerals fail to compile.
+		 */
+		constexpr int operator ""_roman(char const* const value, std::size_t const length) {
+			return parse_roman({ value, length });
+		}
+	}
 }
@@ -0,0 +1,454 @@
+#include <benchmark/benchmark.h>
+
+#include "roman_numeral_converter.hxx"
+#include "../../examples/counting_memory_resource.hxx"
+namespace w = workshop;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+	// the benchmarks producing strings use std::pmr::string from here, so their allocations can be counted
+	counting_memory_resource counting{};
+
+	// time per conversion besides the time per iteration, which covers many conversions
+	void reportPerOp(benchmark::State& state, std::int64_t const opsPerIteration) {
+		std::int64_t const ops = state.iterations() * opsPerIteration;
+		state.SetItemsProcessed(ops);
+		state.counters["time_per_op"] = benchmark::Counter(static_cast<double>(ops), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+	}
+
+	// and the allocations per conversion from counting since it had made allocationsBefore of them
+	void reportPerOp(benchmark::State& state, std::int64_t const opsPerIteration, std::size_t const allocationsBefore) {
+		reportPerOp(state, opsPerIteration);
+		std::int64_t const ops = state.iterations() * opsPerIteration;
+		state.counters["allocs_per_op"] = static_cast<double>(counting.allocations() - allocationsBefore) / static_cast<double>(std::max<std::int64_t>(ops, 1));
+	}
+
+	// the way to_roman used to work, building a temporary string per mapping step
+	std::array<std::tuple<std::string_view, int>, 13> const mapping{
+		std::tuple{ "M", 1000 }, std::tuple{ "CM", 900 }, std::tuple{ "D", 500 }, std::tuple{ "CD", 400 },
+		std::tuple{ "C", 100 }, std::tuple{ "XC", 90 }, std::tuple{ "L", 50 }, std::tuple{ "XL", 40 },
+		std::tuple{ "X", 10 }, std::tuple{ "IX", 9 }, std::tuple{ "V", 5 }, std::tuple{ "IV", 4 },
+		std::tuple{ "I", 1 },
+	};
+
+	std::pmr::string operator * (std::string_view part, int count) {
+		std::pmr::string result{ &counting };
+		while (count--) {
+			result += part;
+		}
+		return result;
+	}
+
+	std::pmr::string to_roman_multiplying(int value) {
+		std::pmr::string result{ &counting };
+		for (auto const& [roman, arabic] : mapping) {
+			int const count = value / arabic;
+			value %= arabic;
+			result += roman * count;
+			if (value == 0)
+				break;
+		}
+		return result;
+	}
+
+	// all values once per iteration, like formatting log records
+	void BM_to_roman_multiplying(benchmark::State& state) {
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(to_roman_multiplying(n));
+			}
+		}
+		reportPerOp(state, 3999, before);
+	}
+
+	void BM_to_roman_string(benchmark::State& state) {
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(w::to_roman(n, &counting));
+			}
+		}
+		reportPerOp(state, 3999, before);
+	}
+
+	void BM_to_roman_buffer(benchmark::State& state) {
+		std::array<char, w::max_roman_length> buffer{};
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(w::to_roman(buffer.data(), buffer.data() + buffer.size(), n));
+			}
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, 3999);
+	}
+
+	void BM_to_roman_view(benchmark::State& state) {
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(w::to_roman_view(n));
+			}
+		}
+		reportPerOp(state, 3999);
+	}
+
+	// the way from_roman used to work, a node based map and a temporary string per lookup
+	void BM_from_roman_unordered_map(benchmark::State& state) {
+		std::pmr::unordered_map<std::pmr::string, int> reverse_mapping{ &counting };
+		for (int n = 1; n <= 3999; ++n) {
+			reverse_mapping.emplace(w::to_roman(n, &counting), n);
+		}
+
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(reverse_mapping.find(std::pmr::string{ w::to_roman_view(n), &counting })->second);
+			}
+		}
+		reportPerOp(state, 3999, before);
+	}
+
+	void BM_from_roman(benchmark::State& state) {
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				benchmark::DoNotOptimize(w::from_roman(w::to_roman_view(n)));
+			}
+		}
+		reportPerOp(state, 3999);
+	}
+
+	void BM_append_roman(benchmark::State& state) {
+		std::string record{};
+		for (auto _ : state) {
+			for (int n = 1; n <= 3999; ++n) {
+				record.clear();
+				w::append_roman(record, n);
+				benchmark::DoNotOptimize(record.data());
+			}
+		}
+		reportPerOp(state, 3999);
+	}
+
+	// a column of years, with every 64th value out of range
+	constexpr std::size_t columnSize = 1u << 18u;
+
+	std::vector<int> const& yearColumn() {
+		static std::vector<int> const column = [] {
+			std::vector<int> values(columnSize);
+			for (std::size_t n = 0u; n < columnSize; ++n) {
+				values[n] = n % 64u == 63u ? 4000 : static_cast<int>(n % 3999u) + 1;
+			}
+			return values;
+		}();
+		return column;
+	}
+
+	std::vector<std::string_view> const& numeralColumn() {
+		static std::vector<std::string_view> const column = [] {
+			std::vector<std::string_view> numerals(columnSize);
+			for (std::size_t n = 0u; n < columnSize; ++n) {
+				numerals[n] = n % 64u == 63u ? std::string_view{ "MMMM" } : w::to_roman_view(static_cast<int>(n % 3999u) + 1);
+			}
+			return numerals;
+		}();
+		return column;
+	}
+
+	void BM_to_roman_column_per_value(benchmark::State& state) {
+		auto const& values = yearColumn();
+		std::pmr::vector<std::pmr::string> numerals(values.size(), &counting);
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (std::size_t n = 0u; n < values.size(); ++n) {
+				try {
+					numerals[n] = w::to_roman(values[n], &counting);
+				}
+				catch (std::invalid_argument const&) {
+					numerals[n].clear();
+				}
+			}
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()), before);
+	}
+
+	// the number of workers is the argument
+	void BM_to_roman_batch(benchmark::State& state) {
+		auto const& values = yearColumn();
+		std::vector<std::string_view> numerals(values.size());
+		std::vector<std::uint64_t> errors((values.size() + 63u) / 64u);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(w::to_roman_batch(values.data(), values.size(), numerals.data(), errors.data(), static_cast<int>(state.range(0))));
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()));
+	}
+
+	void BM_from_roman_column_per_value(benchmark::State& state) {
+		auto const& numerals = numeralColumn();
+		std::vector<int> values(numerals.size());
+		for (auto _ : state) {
+			for (std::size_t n = 0u; n < numerals.size(); ++n) {
+				try {
+					values[n] = w::from_roman(numerals[n]);
+				}
+				catch (std::invalid_argument const&) {
+					values[n] = 0;
+				}
+			}
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, static_cast<std::int64_t>(numerals.size()));
+	}
+
+	void BM_from_roman_batch(benchmark::State& state) {
+		auto const& numerals = numeralColumn();
+		std::vector<int> values(numerals.size());
+		std::vector<std::uint64_t> errors((numerals.size() + 63u) / 64u);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(w::from_roman_batch(numerals.data(), numerals.size(), values.data(), errors.data(), static_cast<int>(state.range(0))));
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, static_cast<std::int64_t>(numerals.size()));
+	}
+
+	// the same column read from a file, one numeral per line
+	void BM_from_roman_lines(benchmark::State& state) {
+		std::string text{};
+		for (auto const numeral : numeralColumn()) {
+			text += numeral;
+			text += '\n';
+		}
+		std::vector<int> values(columnSize);
+		std::vector<std::uint64_t> errors((columnSize + 63u) / 64u);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(w::from_roman_lines(text, values.data(), errors.data(), static_cast<int>(state.range(0))));
+			benchmark::ClobberMemory();
+		}
+		reportPerOp(state, static_cast<std::int64_t>(columnSize));
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+	}
+
+	// ingest feeds where every other record is broken
+	std::vector<int> const& halfInvalidYears() {
+		static std::vector<int> const column = [] {
+			std::vector<int> values(4096u);
+			for (std::size_t n = 0u; n < values.size(); ++n) {
+				values[n] = n % 2u ? -static_cast<int>(n) : static_cast<int>(n % 3999u) + 1;
+			}
+			return values;
+		}();
+		return column;
+	}
+
+	std::vector<std::string_view> const& halfInvalidNumerals() {
+		static std::vector<std::string_view> const column = [] {
+			std::vector<std::string_view> numerals(4096u);
+			for (std::size_t n = 0u; n < numerals.size(); ++n) {
+				numerals[n] = n % 2u ? std::string_view{ "MCMXCIXI" } : w::to_roman_view(static_cast<int>(n % 3999u) + 1);
+			}
+			return numerals;
+		}();
+		return column;
+	}
+
+	void BM_to_roman_view_half_invalid(benchmark::State& state) {
+		auto const& values = halfInvalidYears();
+		for (auto _ : state) {
+			for (int const value : values) {
+				try {
+					benchmark::DoNotOptimize(w::to_roman_view(value));
+				}
+				catch (std::invalid_argument const&) {
+					benchmark::DoNotOptimize(value);
+				}
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()));
+	}
+
+	void BM_try_to_roman_half_invalid(benchmark::State& state) {
+		auto const& values = halfInvalidYears();
+		for (auto _ : state) {
+			for (int const value : values) {
+				benchmark::DoNotOptimize(w::try_to_roman(value));
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()));
+	}
+
+	void BM_from_roman_half_invalid(benchmark::State& state) {
+		auto const& numerals = halfInvalidNumerals();
+		for (auto _ : state) {
+			for (auto const numeral : numerals) {
+				try {
+					benchmark::DoNotOptimize(w::from_roman(numeral));
+				}
+				catch (std::invalid_argument const&) {
+					benchmark::DoNotOptimize(numeral);
+				}
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(numerals.size()));
+	}
+
+	void BM_try_from_roman_half_invalid(benchmark::State& state) {
+		auto const& numerals = halfInvalidNumerals();
+		for (auto _ : state) {
+			for (auto const numeral : numerals) {
+				benchmark::DoNotOptimize(w::try_from_roman(numeral));
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(numerals.size()));
+	}
+
+	// values in random order, so the branch predictor cannot learn the sequence
+	std::vector<int> const& randomYears() {
+		static std::vector<int> const values = [] {
+			std::mt19937 random{ 1994u };
+			std::uniform_int_distribution<int> distribution{ 1, 3999 };
+			std::vector<int> result(4096u);
+			for (int& value : result) {
+				value = distribution(random);
+			}
+			return result;
+		}();
+		return values;
+	}
+
+	void BM_to_roman_random(benchmark::State& state) {
+		auto const& values = randomYears();
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (int const value : values) {
+				benchmark::DoNotOptimize(w::to_roman(value, &counting));
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()), before);
+	}
+
+	void BM_from_roman_random(benchmark::State& state) {
+		std::vector<std::string_view> numerals{};
+		for (int const value : randomYears()) {
+			numerals.push_back(w::to_roman_view(value));
+		}
+
+		for (auto _ : state) {
+			for (auto const numeral : numerals) {
+				benchmark::DoNotOptimize(w::from_roman(numeral));
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(numerals.size()));
+	}
+
+	// only invalid input, rejected at the start, in the middle and at the end of the numeral
+	std::array<std::string_view, 8> const invalidNumerals{
+		"", "mcm", "IIII", "MCMXCIXI", "MMMM", "VX", "MCMXCIVA", "XIIIIIIIIIII",
+	};
+
+	void BM_from_roman_invalid(benchmark::State& state) {
+		for (auto _ : state) {
+			for (auto const numeral : invalidNumerals) {
+				try {
+					benchmark::DoNotOptimize(w::from_roman(numeral));
+				}
+				catch (std::invalid_argument const&) {
+					benchmark::DoNotOptimize(numeral);
+				}
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(invalidNumerals.size()));
+	}
+
+	void BM_try_from_roman_invalid(benchmark::State& state) {
+		for (auto _ : state) {
+			for (auto const numeral : invalidNumerals) {
+				benchmark::DoNotOptimize(w::try_from_roman(numeral));
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(invalidNumerals.size()));
+	}
+
+	void BM_to_roman_invalid(benchmark::State& state) {
+		std::array<int, 4> const values{ 0, -1, 4000, 65536 };
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			for (int const value : values) {
+				try {
+					benchmark::DoNotOptimize(w::to_roman(value, &counting));
+				}
+				catch (std::invalid_argument const&) {
+					benchmark::DoNotOptimize(value);
+				}
+			}
+		}
+		reportPerOp(state, static_cast<std::int64_t>(values.size()), before);
+	}
+
+	// strings of the given length made of Roman letters, the automaton gives up after at most 16 of them
+	void BM_try_from_roman_long(benchmark::State& state) {
+		std::string numeral{};
+		while (numeral.size() < static_cast<std::size_t>(state.range(0))) {
+			numeral += "MMMDCCCLXXXVIII";
+		}
+		numeral.resize(static_cast<std::size_t>(state.range(0)));
+
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(w::try_from_roman(numeral));
+		}
+		reportPerOp(state, 1);
+	}
+
+	// what the first from_roman call used to pay while it built the reverse mapping lazily,
+	// the tables it uses now are constant initialized, so its first call costs what BM_from_roman measures
+	void BM_build_reverse_mapping_unordered_map(benchmark::State& state) {
+		std::size_t const before = counting.allocations();
+		for (auto _ : state) {
+			std::pmr::unordered_map<std::pmr::string, int> reverse_mapping{ &counting };
+			for (int n = 1; n <= 3999; ++n) {
+				reverse_mapping.emplace(w::to_roman(n, &counting), n);
+			}
+			benchmark::DoNotOptimize(reverse_mapping.find("MCMXCIV")->second);
+		}
+		reportPerOp(state, 1, before);
+	}
+}
+
+BENCHMARK(BM_to_roman_multiplying);
+BENCHMARK(BM_to_roman_string);
+BENCHMARK(BM_to_roman_buffer);
+BENCHMARK(BM_to_roman_view);
+BENCHMARK(BM_append_roman);
+BENCHMARK(BM_from_roman_unordered_map);
+BENCHMARK(BM_from_roman);
+BENCHMARK(BM_to_roman_column_per_value);
+BENCHMARK(BM_to_roman_batch)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_from_roman_column_per_value);
+BENCHMARK(BM_from_roman_batch)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_from_roman_lines)->Arg(1)->Arg(4)->UseRealTime();
+BENCHMARK(BM_to_roman_view_half_invalid);
+BENCHMARK(BM_try_to_roman_half_invalid);
+BENCHMARK(BM_from_roman_half_invalid);
+BENCHMARK(BM_try_from_roman_half_invalid);
+
+BENCHMARK(BM_to_roman_random);
+BENCHMARK(BM_from_roman_random);
+BENCHMARK(BM_to_roman_invalid);
+BENCHMARK(BM_from_roman_invalid);
+BENCHMARK(BM_try_from_roman_invalid);
+BENCHMARK(BM_try_from_roman_long)->Range(16, 1 << 16);
+BENCHMARK(BM_build_reverse_mapping_unordered_map);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+#include "mapped_file.hxx"
+#include "roman_numeral_converter.hxx"
+namespace w = workshop;
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+	// large enough for the write calls to not matter, small enough to keep all workers busy
+	constexpr std::size_t chunkSize = 8u * 1024u * 1024u;
+	// "3999\n"
+	constexpr std::size_t maxLineLength = 5u;
+
+	struct Converted final {
+		std::string text;
+		std::size_t lines;
+		std::size_t invalid;
+	};
+
+	// one value per line, invalid numerals become empty lines so line numbers stay the same
+	Converted convert(std::string_view const chunk) {
+		std::size_t const lines = w::count_lines(chunk);
+		std::vector<int> values(lines);
+		std::vector<std::uint64_t> errors((lines + 63u) / 64u);
+		std::size_t const invalid = w::from_roman_lines(chunk, values.data(), errors.data());
+
+		std::string text(lines * maxLineLength, '\0');
+		char* out = text.data();
+		for (int const value : values) {
+			if (value != 0)
+				out = std::to_chars(out, out + maxLineLength, value).ptr;
+			*out++ = '\n';
+		}
+		text.resize(static_cast<std::size_t>(out - text.data()));
+		return { std::move(text), lines, invalid };
+	}
+
+	// the end of the chunk starting at begin, just behind a newline unless it is the end of the text
+	std::size_t chunkEnd(std::string_view const text, std::size_t const begin) {
+		if (text.size() - begin <= chunkSize)
+			return text.size();
+		std::size_t const newline = text.find('\n', begin + chunkSize);
+		return newline == std::string_view::npos ? text.size() : newline + 1u;
+	}
+
+	int usage(char const* const program) {
+		std::fprintf(stderr,
+			"usage: %s [-j workers] input [output]\n"
+			"Converts a file of Roman numerals, one per line, to decimal numbers written to output or stdout.\n"
+			"Invalid numerals become empty lines. Exits with 1 if there were any, 2 on errors.\n",
+			program);
+		return 2;
+	}
+}
+
+int main(int argc, char** argv) {
+	unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+	int arg = 1;
+	if (arg + 1 < argc && std::strcmp(argv[arg], "-j") == 0) {
+		workers = static_cast<unsigned>(std::max(1, std::atoi(argv[arg + 1])));
+		arg += 2;
+	}
+	if (arg >= argc || argc - arg > 2)
+		return usage(argv[0]);
+
+	try {
+		auto const start = std::chrono::steady_clock::now();
+
+		w::mapped_file const input{ argv[arg] };
+		std::FILE* const output = argc - arg == 2 ? std::fopen(argv[arg + 1], "wb") : stdout;
+		if (!output)
+			throw std::system_error{ errno, std::generic_category(), "opening output" };
+		// the chunks are written in one call each, buffering would only copy them once more
+		std::setvbuf(output, nullptr, _IONBF, 0u);
+
+		std::string_view const text = input.view();
+		std::size_t lines{ 0u };
+		std::size_t invalid{ 0u };
+		bool failed{ false };
+
+		// up to one chunk per worker is converted while the oldest one is written
+		std::deque<std::future<Converted>> pending{};
+		std::size_t begin{ 0u };
+		while (begin < text.size() || !pending.empty()) {
+			while (begin < text.size() && pending.size() < workers) {
+				std::size_t const end = chunkEnd(text, begin);
+				pending.push_back(std::async(std::launch::async, convert, text.substr(begin, end - begin)));
+				begin = end;
+			}
+
+			Converted const converted = pending.front().get();
+			pending.pop_front();
+			lines += converted.lines;
+			invalid += converted.invalid;
+			failed = failed || std::fwrite(converted.text.data(), 1u, converted.text.size(), output) != converted.text.size();
+		}
+
+		if (output != stdout)
+			failed = std::fclose(output) != 0 || failed;
+		if (failed)
+			throw std::system_error{ errno, std::generic_category(), "writing output" };
+
+		std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+		std::fprintf(stderr, "%zu lines, %zu invalid, %zu bytes in %.3f s: %.2f GB/s\n",
+			lines, invalid, text.size(), elapsed.count(), static_cast<double>(text.size()) / elapsed.count() / 1e9);
+		return invalid == 0u ? 0 : 1;
+	}
+	catch (std::exception const& error) {
+		std::fprintf(stderr, "%s\n", error.what());
+		return 2;
+	}
+}
@@ -1,10 +1,19 @@
 #include "roman_numeral_converter.hxx"
+#include "../../examples/counting_memory_resource.hxx"
 namespace w = workshop;
 
 #include <gtest/gtest.h>
 namespace t = testing;
 
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 namespace s = std;
 
 // Test Funktionen
@@ -14,6 +23,11 @@ TEST_P(InvalidRomanNumeralFixture, throws_invalid_argument)
 	ASSERT_THROW(w::from_roman(GetParam()), s::invalid_argument);
 }
 
+TEST_P(InvalidRomanNumeralFixture, returns_nothing)
+{
+	ASSERT_EQ(s::nullopt, w::try_from_roman(GetParam()));
+}
+
 using InvalidIntegerFixture = t::TestWithParam<int>;
 TEST_P(InvalidIntegerFixture, throws_invalid_argument)
 {
@@ -35,11 +49,346 @@ TEST_P(RomanNumeralConversionFixture, converts_from_roman)
 	ASSERT_EQ(value, w::from_roman(roman));
 }
 
+TEST_P(RomanNumeralConversionFixture, tries_to_convert)
+{
+	auto const& [value, roman] = GetParam();
+	ASSERT_EQ(s::optional<s::string_view>{ roman }, w::try_to_roman(value));
+	ASSERT_EQ(s::optional<int>{ value }, w::try_from_roman(roman));
+}
+
+TEST_P(RomanNumeralConversionFixture, converts_to_roman_into_buffer)
+{
+	auto const& [value, roman] = GetParam();
+	s::array<char, w::max_roman_length> buffer{};
+	auto const [end, error] = w::to_roman(buffer.data(), buffer.data() + buffer.size(), value);
+	ASSERT_EQ(s::errc{}, error);
+	ASSERT_EQ(roman, s::string_view(buffer.data(), static_cast<s::size_t>(end - buffer.data())));
+}
+
+TEST_P(RomanNumeralConversionFixture, converts_to_roman_view)
+{
+	auto const& [value, roman] = GetParam();
+	ASSERT_EQ(roman, w::to_roman_view(value));
+}
+
+TEST_P(RomanNumeralConversionFixture, appends_to_string)
+{
+	auto const& [value, roman] = GetParam();
+	s::string result{ "> " };
+	w::append_roman(result, value);
+	ASSERT_EQ(s::string{ "> " } + roman, result);
+}
+
+TEST_P(InvalidIntegerFixture, reports_invalid_argument)
+{
+	s::array<char, w::max_roman_length> buffer{};
+	auto const [end, error] = w::to_roman(buffer.data(), buffer.data() + buffer.size(), GetParam());
+	ASSERT_EQ(s::errc::invalid_argument, error);
+	ASSERT_EQ(buffer.data() + buffer.size(), end);
+
+	s::string result{};
+	ASSERT_THROW(w::append_roman(result, GetParam()), s::invalid_argument);
+	ASSERT_THROW(w::to_roman_view(GetParam()), s::invalid_argument);
+	ASSERT_EQ(s::nullopt, w::try_to_roman(GetParam()));
+}
+
+TEST(RomanNumeralConverterTest, reports_too_small_buffers)
+{
+	s::array<char, w::max_roman_length> buffer{};
+	auto const [end, error] = w::to_roman(buffer.data(), buffer.data() + w::max_roman_length - 1u, 3888);
+	ASSERT_EQ(s::errc::value_too_large, error);
+	ASSERT_EQ(buffer.data() + w::max_roman_length - 1u, end);
+
+	ASSERT_EQ(s::errc{}, w::to_roman(buffer.data(), buffer.data() + w::max_roman_length, 3888).ec);
+	ASSERT_EQ(s::errc::value_too_large, w::to_roman(buffer.data(), buffer.data(), 1).ec);
+}
+
+TEST(RomanNumeralConverterTest, views_all_numerals_back_to_back)
+{
+	for (int value = 1; value < 3999; ++value) {
+		auto const roman = w::to_roman_view(value);
+		ASSERT_GE(w::max_roman_length, roman.size());
+		ASSERT_EQ(roman.data() + roman.size(), w::to_roman_view(value + 1).data());
+		ASSERT_EQ(value, w::from_roman(roman));
+	}
+	ASSERT_EQ("MMMDCCCLXXXVIII", w::to_roman_view(3888));
+}
+
+namespace {
+	// the tables shared with the header, the numeral table of the implementation is checked there
+	static_assert(sizeof(w::detail::automaton) + sizeof(w::detail::letters) + sizeof(w::detail::digits) <= 4u * 1024u);
+
+	// installs resource as the default resource for the lifetime of the guard, even if a test fails
+	class DefaultResourceGuard final {
+	public:
+		explicit DefaultResourceGuard(s::pmr::memory_resource * const resource) noexcept
+			: m_previous{s::pmr::set_default_resource(resource)}
+		{}
+
+		DefaultResourceGuard(DefaultResourceGuard const&) = delete;
+		DefaultResourceGuard& operator = (DefaultResourceGuard const&) = delete;
+
+		~DefaultResourceGuard() noexcept {
+			s::pmr::set_default_resource(m_previous);
+		}
+
+	private:
+		s::pmr::memory_resource * m_previous;
+	};
+}
+
+TEST(RomanNumeralConverterTest, converts_without_touching_the_default_resource)
+{
+	// throws std::bad_alloc on any allocation from the default resource, and counts it
+	counting_memory_resource resource{ s::pmr::null_memory_resource() };
+	DefaultResourceGuard const guard{ &resource };
+
+	s::array<char, w::max_roman_length> buffer{};
+	s::array<int, 3999> values{};
+	s::array<s::string_view, 3999> numerals{};
+	s::array<s::uint64_t, (3999u + 63u) / 64u> errors{};
+	for (int n = 1; n <= 3999; ++n) {
+		values[static_cast<s::size_t>(n - 1)] = n;
+		auto const [end, error] = w::to_roman(buffer.data(), buffer.data() + buffer.size(), n);
+		ASSERT_EQ(s::errc{}, error);
+		s::string_view const roman{ buffer.data(), static_cast<s::size_t>(end - buffer.data()) };
+		ASSERT_EQ(roman, w::to_roman_view(n));
+		ASSERT_EQ(roman, w::try_to_roman(n));
+		ASSERT_EQ(n, w::from_roman(roman));
+		ASSERT_EQ(n, w::try_from_roman(roman));
+	}
+	ASSERT_EQ(0u, w::to_roman_batch(values.data(), values.size(), numerals.data(), errors.data()));
+	ASSERT_EQ(0u, w::from_roman_batch(numerals.data(), numerals.size(), values.data(), errors.data()));
+	ASSERT_EQ(0u, resource.allocations());
+}
+
+TEST(RomanNumeralConverterTest, allocates_from_the_given_resource)
+{
+	counting_memory_resource resource{};
+	{
+		s::pmr::string const roman = w::to_roman(3888, &resource);
+		ASSERT_EQ("MMMDCCCLXXXVIII", roman);
+		ASSERT_EQ(&resource, roman.get_allocator().resource());
+
+		s::pmr::vector<s::pmr::string> numerals{ &resource };
+		for (int n = 1; n <= 100; ++n) {
+			numerals.push_back(w::to_roman(n, &resource));
+		}
+		ASSERT_EQ("C", numerals.back());
+		ASSERT_LT(0u, resource.allocations());
+	}
+	ASSERT_EQ(0u, resource.bytes_in_use());
+}
+
+namespace {
+	// parses by looking the numeral up among all valid ones, 0 if it is not a valid numeral
+	int from_roman_by_lookup(s::string const& roman) {
+		static s::unordered_map<s::string, int> const reverse_mapping = [] {
+			s::unordered_map<s::string, int> rmap{};
+			for (int n = 1; n <= 3999; ++n) {
+				rmap.emplace(w::to_roman(n), n);
+			}
+			return rmap;
+		}();
+
+		auto const it = reverse_mapping.find(roman);
+		return it == reverse_mapping.end() ? 0 : it->second;
+	}
+
+	int from_roman_or_zero(s::string const& roman) {
+		try {
+			return w::from_roman(roman);
+		}
+		catch (s::invalid_argument const&) {
+			return 0;
+		}
+	}
+}
+
+TEST(RomanNumeralConverterTest, parses_all_short_strings_like_lookup)
+{
+	s::string_view const alphabet{ "IVXLCDMA" };
+	s::string roman{};
+	// every string of up to 6 letters, counting in base 8
+	for (int length = 1; length <= 6; ++length) {
+		s::vector<s::size_t> digits(static_cast<s::size_t>(length), 0u);
+		for (;;) {
+			roman.clear();
+			for (auto const digit : digits) {
+				roman += alphabet[digit];
+			}
+			ASSERT_EQ(from_roman_by_lookup(roman), from_roman_or_zero(roman)) << roman;
+			ASSERT_EQ(from_roman_by_lookup(roman), w::try_from_roman(roman).value_or(0)) << roman;
+
+			s::size_t position = 0u;
+			while (position < digits.size() && ++digits[position] == alphabet.size()) {
+				digits[position++] = 0u;
+			}
+			if (position == digits.size())
+				break;
+		}
+	}
+}
+
+TEST(RomanNumeralConverterTest, parses_all_numerals_and_their_typos_like_lookup)
+{
+	s::string_view const alphabet{ "IVXLCDM" };
+	for (int n = 1; n <= 3999; ++n) {
+		s::string const roman = w::to_roman(n);
+		ASSERT_EQ(n, w::from_roman(roman));
+
+		for (s::size_t position = 0u; position <= roman.size(); ++position) {
+			s::string typo{ roman };
+			if (position < roman.size()) {
+				typo.erase(position, 1u);
+				ASSERT_EQ(from_roman_by_lookup(typo), from_roman_or_zero(typo)) << typo;
+			}
+			for (char const letter : alphabet) {
+				typo = roman;
+				typo.insert(position, 1u, letter);
+				ASSERT_EQ(from_roman_by_lookup(typo), from_roman_or_zero(typo)) << typo;
+			}
+		}
+	}
+}
+
+namespace {
+	using namespace w::literals;
+
+	static_assert("MCMXCIV"_roman == 1994);
+	static_assert(w::parse_roman("MMMCMXCIX") == 3999);
+	static_assert(w::make_roman(1994).view() == "MCMXCIV");
+	static_assert(w::make_roman(3888).view().size() == w::max_roman_length);
+}
+
+TEST(RomanNumeralConverterTest, converts_at_compile_time_like_at_run_time)
+{
+	for (int n = 1; n <= 3999; ++n) {
+		w::roman_numeral const numeral = w::make_roman(n);
+		ASSERT_EQ(w::to_roman_view(n), numeral.view());
+		ASSERT_EQ(n, w::parse_roman(numeral));
+	}
+	ASSERT_THROW(w::make_roman(0), s::invalid_argument);
+	ASSERT_THROW(w::parse_roman("IIII"), s::invalid_argument);
+}
+
+namespace {
+	bool bit(s::vector<s::uint64_t> const& errors, s::size_t const n) {
+		return (errors[n / 64u] >> (n % 64u)) & 1u;
+	}
+}
+
+TEST(RomanNumeralConverterTest, converts_batches_like_single_values)
+{
+	s::vector<int> values{};
+	// large enough for several workers
+	for (int round = 0; round < 20; ++round) {
+		for (int n = -10; n <= 4010; ++n) {
+			values.push_back(n);
+		}
+	}
+
+	for (int const workers : { 1, 4 }) {
+		s::vector<s::string_view> numerals(values.size());
+		s::vector<s::uint64_t> errors((values.size() + 63u) / 64u, ~s::uint64_t{ 0 });
+		s::size_t const invalid = w::to_roman_batch(values.data(), values.size(), numerals.data(), errors.data(), workers);
+
+		ASSERT_EQ(20u * 22u, invalid);
+		for (s::size_t n = 0u; n < values.size(); ++n) {
+			bool const valid = values[n] >= 1 && values[n] <= 3999;
+			ASSERT_EQ(!valid, bit(errors, n)) << values[n];
+			ASSERT_EQ(valid ? w::to_roman_view(values[n]) : s::string_view{}, numerals[n]) << values[n];
+		}
+	}
+}
+
+TEST(RomanNumeralConverterTest, parses_batches_like_single_numerals)
+{
+	s::vector<s::string> romans{};
+	for (int round = 0; round < 20; ++round) {
+		for (int n = 1; n <= 3999; ++n) {
+			romans.push_back(w::to_roman(n));
+			if (n % 100 == 0)
+				romans.push_back(romans.back() + "I");
+		}
+		romans.emplace_back();
+		romans.emplace_back("IIII");
+		romans.emplace_back("mcm");
+	}
+	s::vector<s::string_view> const numerals(romans.begin(), romans.end());
+
+	for (int const workers : { 1, 4 }) {
+		s::vector<int> values(numerals.size(), -1);
+		s::vector<s::uint64_t> errors((numerals.size() + 63u) / 64u, ~s::uint64_t{ 0 });
+		s::size_t const invalid = w::from_roman_batch(numerals.data(), numerals.size(), values.data(), errors.data(), workers);
+
+		s::size_t expected = 0u;
+		for (s::size_t n = 0u; n < numerals.size(); ++n) {
+			int const value = from_roman_or_zero(romans[n]);
+			expected += value == 0 ? 1u : 0u;
+			ASSERT_EQ(value, values[n]) << romans[n];
+			ASSERT_EQ(value == 0, bit(errors, n)) << romans[n];
+		}
+		ASSERT_EQ(expected, invalid);
+	}
+}
+
+TEST(RomanNumeralConverterTest, counts_lines)
+{
+	ASSERT_EQ(0u, w::count_lines(""));
+	ASSERT_EQ(1u, w::count_lines("I"));
+	ASSERT_EQ(1u, w::count_lines("I\n"));
+	ASSERT_EQ(2u, w::count_lines("I\nII"));
+	ASSERT_EQ(2u, w::count_lines("\n\n"));
+	ASSERT_EQ(3u, w::count_lines("I\r\nII\r\nIII an incomplete line longer than sixteen characters"));
+}
+
+TEST(RomanNumeralConverterTest, parses_lines_like_single_numerals)
+{
+	s::vector<s::string> romans{};
+	s::string text{};
+	// large enough for several workers
+	for (int round = 0; round < 40; ++round) {
+		for (int n = 1; n <= 3999; ++n) {
+			romans.push_back(n % 7 == 0 ? w::to_roman(n) + "\r" : w::to_roman(n));
+			if (n % 500 == 0)
+				romans.emplace_back("MMMM");
+			if (n % 1000 == 0)
+				romans.emplace_back();
+		}
+	}
+	for (auto const& roman : romans) {
+		text += roman;
+		text += '\n';
+	}
+	// the last line lacks its newline
+	text.pop_back();
+
+	ASSERT_EQ(romans.size(), w::count_lines(text));
+	for (int const workers : { 1, 4 }) {
+		s::vector<int> values(romans.size(), -1);
+		s::vector<s::uint64_t> errors((romans.size() + 63u) / 64u, ~s::uint64_t{ 0 });
+		s::size_t const invalid = w::from_roman_lines(text, values.data(), errors.data(), workers);
+
+		s::size_t expected = 0u;
+		for (s::size_t n = 0u; n < romans.size(); ++n) {
+			s::string roman = romans[n];
+			if (!roman.empty() && roman.back() == '\r')
+				roman.pop_back();
+			int const value = from_roman_or_zero(roman);
+			expected += value == 0 ? 1u : 0u;
+			ASSERT_EQ(value, values[n]) << n;
+			ASSERT_EQ(value == 0, bit(errors, n)) << n;
+		}
+		ASSERT_EQ(expected, invalid);
+	}
+}
+
 // Test Daten
 INSTANTIATE_TEST_SUITE_P(
 	RomanNumeralConverterTest,
 	InvalidRomanNumeralFixture,
-	t::Values("", "A", "ABC", "alpha", "mx", "23", "M!", "XF", "MMS", "IIX", "IXI", "IM", "IIM", "IIIM", "IIII", "IIIII", "IIIIIIII", "LC", "LL", "CCCC", "MMMM", "MIM", "XM", "MXM", "XXC", "CXLICMIM", "XCX", "MXCX", "XCXCXC", "MIMIMI", "XCXL"));
+	t::Values("", "A", "ABC", "alpha", "mx", "23", "M!", "XF", "MMS", "IIX", "IXI", "IM", "IIM", "IIIM", "IIII", "IIIII", "IIIIIIII", "LC", "LL", "CCCC", "MMMM", "MIM", "XM", "MXM", "XXC", "CXLICMIM", "XCX", "MXCX", "XCXCXC", "MIMIMI", "XCXL", "MMMDCCCLXXXVIIII", "MMMDCCCLXXXVIIIMMMDCCCLXXXVIII", "\xC9"));
 
 INSTANTIATE_TEST_SUITE_P(
 	RomanNumeralConverterTest,
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+ * The tables both the run time and the compile time conversions are built on, so they cannot disagree.
+ */
+namespace workshop::detail {
+	// the numerals of the digits of each decade, thousands first
+	inline constexpr std::array<std::array<std::string_view, 10>, 4> digits{ {
+		{ "", "M", "MM", "MMM" },
+		{ "", "C", "CC", "CCC", "CD", "D", "DC", "DCC", "DCCC", "CM" },
+		{ "", "X", "XX", "XXX", "XL", "L", "LX", "LXX", "LXXX", "XC" },
+		{ "", "I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX" },
+	} };
+
+	constexpr std::array<std::string_view, 4> digitsOf(int const value) {
+		return { digits[0][value / 1000], digits[1][value / 100 % 10], digits[2][value / 10 % 10], digits[3][value % 10] };
+	}
+
+	// the letters of Roman numerals, every other character maps to noLetter
+	inline constexpr std::uint8_t noLetter = 7u;
+
+	constexpr std::array<std::uint8_t, 256> makeLetters() {
+		std::array<std::uint8_t, 256> letters{};
+		for (auto& letter : letters) {
+			letter = noLetter;
+		}
+		std::string_view const roman{ "IVXLCDM" };
+		for (std::uint8_t n = 0u; n < roman.size(); ++n) {
+			letters[static_cast<unsigned char>(roman[n])] = n;
+		}
+		return letters;
+	}
+
+	inline constexpr std::array<std::uint8_t, 256> letters = makeLetters();
+
+	/*
+	 * A deterministic finite automaton reading numerals left to right. Besides the start state it has
+	 * 9 states per decade, one per numeral of a digit ("I" to "IX" for the ones), so every state but the start
+	 * accepts. A transition either extends the digit of the current decade, "I" to "II" or "IV", or starts the
+	 * digit of a lower decade with its one or five. Its delta is the value added by reading the letter.
+	 */
+	struct Transition final {
+		std::uint8_t next;
+		std::uint16_t delta;
+	};
+
+	struct Automaton final {
+		static constexpr std::uint8_t start = 0u;
+		static constexpr std::uint8_t reject = 0xFFu;
+		static constexpr std::uint8_t states = 1u + 4u * 9u;
+
+		std::array<std::array<Transition, noLetter + 1u>, states> transitions;
+	};
+
+	struct Decade final {
+		// letters for one, five and ten, noLetter if there is none
+		std::uint8_t one;
+		std::uint8_t five;
+		std::uint8_t ten;
+		std::uint16_t weight;
+	};
+
+	inline constexpr std::array<Decade, 4> decades{ {
+		{ 6u, noLetter, noLetter, 1000u },
+		{ 4u, 5u, 6u, 100u },
+		{ 2u, 3u, 4u, 10u },
+		{ 0u, 1u, 2u, 1u },
+	} };
+
+	// the state after reading the numeral of digit in the given decade
+	constexpr std::uint8_t stateOf(std::size_t const decade, int const digit) {
+		return static_cast<std::uint8_t>(1u + decade * 9u + static_cast<std::size_t>(digit - 1));
+	}
+
+	constexpr Automaton makeAutomaton() {
+		Automaton automaton{};
+		for (auto& transitions : automaton.transitions) {
+			for (auto& transition : transitions) {
+				transition = { Automaton::reject, 0u };
+			}
+		}
+
+		for (std::size_t decade = 0u; decade < decades.size(); ++decade) {
+			Decade const& letters = decades[decade];
+			auto const link = [&](int const from, std::uint8_t const letter, int const to) {
+				if (letter != noLetter)
+					automaton.transitions[stateOf(decade, from)][letter] = { stateOf(decade, to), static_cast<std::uint16_t>((to - from) * letters.weight) };
+			};
+			link(1, letters.one, 2);
+			link(2, letters.one, 3);
+			link(1, letters.five, 4);
+			link(1, letters.ten, 9);
+			link(5, letters.one, 6);
+			link(6, letters.one, 7);
+			link(7, letters.one, 8);
+
+			// starting this decade from the start or any state of a higher one
+			for (std::uint8_t from = 0u; from < stateOf(decade, 1); ++from) {
+				automaton.transitions[from][letters.one] = { stateOf(decade, 1), letters.weight };
+				if (letters.five != noLetter)
+					automaton.transitions[from][letters.five] = { stateOf(decade, 5), static_cast<std::uint16_t>(5u * letters.weight) };
+			}
+		}
+		return automaton;
+	}
+
+	inline constexpr Automaton automaton = makeAutomaton();
+
+	// the value of the numeral, 0 if it is not a valid numeral
+	constexpr int from_roman_with_automaton(std::string_view const value) noexcept {
+		std::uint8_t state{ Automaton::start };
+		int result{ 0 };
+		for (char const c : value) {
+			Transition const transition = automaton.transitions[state][letters[static_cast<unsigned char>(c)]];
+			if (transition.next == Automaton::reject) {
+				return 0;
+			}
+			state = transition.next;
+			result += transition.delta;
+		}
+		return result;
+	}
+}